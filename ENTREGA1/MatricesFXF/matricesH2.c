@@ -11,57 +11,28 @@ Usa CLOCK_PROCESS_CPUTIME_ID en el caso secuencial para medir cuánta CPU realme
 #include <pthread.h>
 #include <time.h>
 
+#include "../../comun/matriz.h"
+
 typedef struct {
     int inicio, fin, n;
-    int** A;
-    int** B;
-    int** C;
+    const Matriz* A;
+    const Matriz* B;
+    Matriz* C;
 } DatosHilo;
 
-// Función para reservar memoria para una matriz cuadrada
-int** reservar_matriz(int n) {
-    int** matriz = (int**) malloc(n * sizeof(int*));
-    if (!matriz) {
-        perror("Error al asignar memoria");
-        exit(EXIT_FAILURE);
-    }
-    for (int i = 0; i < n; i++) {
-        matriz[i] = (int*) malloc(n * sizeof(int));
-        if (!matriz[i]) {
-            perror("Error al asignar memoria");
-            exit(EXIT_FAILURE);
-        }
-    }
-    return matriz;
-}
-
-// Función para liberar memoria de una matriz
-void liberar_matriz(int** matriz, int n) {
-    for (int i = 0; i < n; i++) {
-        free(matriz[i]);
-    }
-    free(matriz);
-}
-
-// Función para inicializar la matriz con valores aleatorios
-void llenar_matriz(int** matriz, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matriz[i][j] = rand() % 10; // Números entre 0 y 9
-        }
-    }
-}
-
 // Función que ejecutarán los hilos fila por fila
 void* multiplicar_paralelo_fila(void* arg) {
     DatosHilo* datos = (DatosHilo*) arg;
     for (int i = datos->inicio; i < datos->fin; i++) {
+        int* c = FILA(*datos->C, i);
         for (int j = 0; j < datos->n; j++) {
-            datos->C[i][j] = 0;
+            c[j] = 0;
         }
         for (int k = 0; k < datos->n; k++) {
+            int a = ELEM(*datos->A, i, k);
+            const int* b = FILA(*datos->B, k);
             for (int j = 0; j < datos->n; j++) {
-                datos->C[i][j] += datos->A[i][k] * datos->B[k][j];
+                c[j] += a * b[j];
             }
         }
     }
@@ -85,13 +56,13 @@ int main(int argc, char* argv[]) {
     srand(time(NULL));
 
     // Reservar memoria para las matrices
-    int** A = reservar_matriz(n);
-    int** B = reservar_matriz(n);
-    int** C = reservar_matriz(n);
+    Matriz A = reservar_matriz(n);
+    Matriz B = reservar_matriz(n);
+    Matriz C = reservar_matriz(n);
 
     // Llenar matrices con valores aleatorios
-    llenar_matriz(A, n);
-    llenar_matriz(B, n);
+    llenar_matriz(&A);
+    llenar_matriz(&B);
 
     // Medir el tiempo de ejecución
     struct timespec inicio, fin;
@@ -110,9 +81,9 @@ int main(int argc, char* argv[]) {
         datos[i].inicio = inicio_fila;
         datos[i].fin = inicio_fila + filas_a_asignar;
         datos[i].n = n;
-        datos[i].A = A;
-        datos[i].B = B;
-        datos[i].C = C;
+        datos[i].A = &A;
+        datos[i].B = &B;
+        datos[i].C = &C;
 
         pthread_create(&hilos[i], NULL, multiplicar_paralelo_fila, (void*)&datos[i]);
 
@@ -131,9 +102,9 @@ int main(int argc, char* argv[]) {
     printf("\nTiempo de ejecución: %.6f segundos\n", tiempo);
 
     // Liberar memoria
-    liberar_matriz(A, n);
-    liberar_matriz(B, n);
-    liberar_matriz(C, n);
+    liberar_matriz(&A);
+    liberar_matriz(&B);
+    liberar_matriz(&C);
 
     return EXIT_SUCCESS;
 }
@@ -9,68 +9,93 @@ Usa CLOCK_PROCESS_CPUTIME_ID en el caso secuencial para medir cuánta CPU realme
 #include <stdio.h>
 #include <stdlib.h>
 #include <pthread.h>
+#include <string.h>
 #include <time.h>
 
+#include "../../comun/matriz.h"
+#include "../../comun/robo_trabajo.h"
+
+// Cada DatosHilo ocupa sus propias líneas de caché: los hilos escriben
+// tiempo, robos y baldosas sin invalidar los datos de sus vecinos
 typedef struct {
-    int inicio, fin, n;
-    int** A;
-    int** B;
-    int** C;
+    _Alignas(MATRIZ_ALINEACION) int inicio;
+    int fin, n;
+    const Matriz* A;
+    const Matriz* B;
+    Matriz* C;
+    int id;
+    PlanificadorRobo* plan;     // Sólo con --planificador=robo
+    double tiempo;
+    long robos;
+    int baldosas;
 } DatosHilo;
 
-// Función para reservar memoria para una matriz cuadrada
-int** reservar_matriz(int n) {
-    int** matriz = (int**) malloc(n * sizeof(int*));
-    if (!matriz) {
-        perror("Error al asignar memoria");
-        exit(EXIT_FAILURE);
-    }
-    for (int i = 0; i < n; i++) {
-        matriz[i] = (int*) malloc(n * sizeof(int));
-        if (!matriz[i]) {
-            perror("Error al asignar memoria");
-            exit(EXIT_FAILURE);
-        }
-    }
-    return matriz;
-}
-
-// Función para liberar memoria de una matriz
-void liberar_matriz(int** matriz, int n) {
-    for (int i = 0; i < n; i++) {
-        free(matriz[i]);
-    }
-    free(matriz);
-}
-
-// Función para inicializar la matriz con valores aleatorios
-void llenar_matriz(int** matriz, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matriz[i][j] = rand() % 10; // Números entre 0 y 9
-        }
-    }
-}
-
 // Función que ejecutarán los hilos fila por fila
 void* multiplicar_paralelo_fila(void* arg) {
     DatosHilo* datos = (DatosHilo*) arg;
     for (int i = datos->inicio; i < datos->fin; i++) {
+        int* c = FILA(*datos->C, i);
         for (int j = 0; j < datos->n; j++) {
-            datos->C[i][j] = 0;
+            c[j] = 0;
         }
         for (int k = 0; k < datos->n; k++) {
+            int a = ELEM(*datos->A, i, k);
+            const int* b = FILA(*datos->B, k);
             for (int j = 0; j < datos->n; j++) {
-                datos->C[i][j] += datos->A[i][k] * datos->B[k][j];
+                c[j] += a * b[j];
             }
         }
     }
     pthread_exit(NULL);
 }
 
+// Función que ejecutarán los hilos con robo de trabajo sobre baldosas de C
+void* multiplicar_robo_baldosas(void* arg) {
+    DatosHilo* datos = (DatosHilo*) arg;
+    struct timespec inicio, fin;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &inicio);
+
+    Baldosa b;
+    datos->robos = 0;
+    datos->baldosas = 0;
+    while (siguiente_baldosa(datos->plan, datos->id, &b, &datos->robos)) {
+        for (int i = b.i0; i < b.i1; i++) {
+            int* c = FILA(*datos->C, i);
+            for (int j = b.j0; j < b.j1; j++) {
+                c[j] = 0;
+            }
+            for (int k = 0; k < datos->n; k++) {
+                int a = ELEM(*datos->A, i, k);
+                const int* bk = FILA(*datos->B, k);
+                for (int j = b.j0; j < b.j1; j++) {
+                    c[j] += a * bk[j];
+                }
+            }
+        }
+        datos->baldosas++;
+    }
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &fin);
+    datos->tiempo = (fin.tv_sec - inicio.tv_sec) + (fin.tv_nsec - inicio.tv_nsec) / 1e9;
+    pthread_exit(NULL);
+}
+
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        fprintf(stderr, "Uso: %s <tamaño de la matriz> <número de hilos>\n", argv[0]);
+    int robo = 0, alto = 0, ancho = 0, valido = argc >= 3;
+    for (int i = 3; valido && i < argc; i++) {
+        if (strcmp(argv[i], "--planificador=robo") == 0) {
+            robo = 1;
+        } else if (strcmp(argv[i], "--planificador=estatico") == 0) {
+            robo = 0;
+        } else if (strncmp(argv[i], "--baldosa=", 10) == 0) {
+            valido = parsear_baldosa(argv[i] + 10, &alto, &ancho) == 0;
+        } else {
+            valido = 0;
+        }
+    }
+    if (!valido) {
+        fprintf(stderr, "Uso: %s <tamaño de la matriz> <número de hilos> "
+                        "[--planificador=estatico|robo] [--baldosa=FxC]\n", argv[0]);
         return EXIT_FAILURE;
     }   
 
@@ -85,13 +110,13 @@ int main(int argc, char* argv[]) {
     srand(time(NULL));
 
     // Reservar memoria para las matrices
-    int** A = reservar_matriz(n);
-    int** B = reservar_matriz(n);
-    int** C = reservar_matriz(n);
+    Matriz A = reservar_matriz(n);
+    Matriz B = reservar_matriz(n);
+    Matriz C = reservar_matriz(n);
 
     // Llenar matrices con valores aleatorios
-    llenar_matriz(A, n);
-    llenar_matriz(B, n);
+    llenar_matriz(&A);
+    llenar_matriz(&B);
 
     // Medir el tiempo de ejecución
     struct timespec inicio, fin;
@@ -101,6 +126,16 @@ int main(int argc, char* argv[]) {
     pthread_t hilos[num_hilos];
     DatosHilo datos[num_hilos];
 
+    // Con robo de trabajo cada hilo parte de un tramo de baldosas en su cola
+    PlanificadorRobo* plan = NULL;
+    if (robo) {
+        if (alto == 0) {
+            baldosa_defecto(n, num_hilos, &alto, &ancho);
+        }
+        plan = crear_planificador(num_hilos);
+        repartir_baldosas(plan, n, n, alto, ancho);
+    }
+
     int filas_por_hilo = n / num_hilos;
     int filas_extra = n % num_hilos;
     int inicio_fila = 0;
@@ -110,11 +145,14 @@ int main(int argc, char* argv[]) {
         datos[i].inicio = inicio_fila;
         datos[i].fin = inicio_fila + filas_a_asignar;
         datos[i].n = n;
-        datos[i].A = A;
-        datos[i].B = B;
-        datos[i].C = C;
+        datos[i].A = &A;
+        datos[i].B = &B;
+        datos[i].C = &C;
+        datos[i].id = i;
+        datos[i].plan = plan;
 
-        pthread_create(&hilos[i], NULL, multiplicar_paralelo_fila, (void*)&datos[i]);
+        pthread_create(&hilos[i], NULL, robo ? multiplicar_robo_baldosas : multiplicar_paralelo_fila,
+                       (void*)&datos[i]);
 
         inicio_fila += filas_a_asignar;
     }
@@ -130,10 +168,19 @@ int main(int argc, char* argv[]) {
     double tiempo = (fin.tv_sec - inicio.tv_sec) + (fin.tv_nsec - inicio.tv_nsec) / 1e9;
     printf("\nTiempo de ejecución: %.6f segundos\n", tiempo);
 
+    // Tiempo de CPU, robos y baldosas de cada hilo
+    if (robo) {
+        for (int i = 0; i < num_hilos; i++) {
+            printf("Hilo %d: tiempo %.6f s, robos %ld, baldosas %d\n",
+                   i, datos[i].tiempo, datos[i].robos, datos[i].baldosas);
+        }
+        destruir_planificador(plan);
+    }
+
     // Liberar memoria
-    liberar_matriz(A, n);
-    liberar_matriz(B, n);
-    liberar_matriz(C, n);
+    liberar_matriz(&A);
+    liberar_matriz(&B);
+    liberar_matriz(&C);
 
     return EXIT_SUCCESS;
 }
@@ -1,57 +1,229 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <pthread.h>
+#include <string.h>
 #include <time.h>
 
+#include "../comun/gemm.h"
+#include "../comun/matriz.h"
+#include "../comun/numa_hpc.h"
+#include "../comun/pool_hilos.h"
+#include "../comun/robo_trabajo.h"
+
+// Cada DatosHilo ocupa sus propias líneas de caché: los hilos escriben
+// tiempo, robos y baldosas sin invalidar los datos de sus vecinos
 typedef struct {
-    int inicio, fin, n;
-    int** A;
-    int** B;
-    int** C;
+    _Alignas(MATRIZ_ALINEACION) int inicio;
+    int fin, n;
+    const Matriz* A;
+    const Matriz* B;
+    Matriz* C;
+    const OpcionesGemm* op;
     double tiempo;
+    PlanificadorRobo* plan;     // NULL con el reparto estático de filas
+    long robos;
+    int baldosas;
 } DatosHilo;
 
-int** reservar_matriz(int n) {
-    int** matriz = (int**) malloc(n * sizeof(int*));
-    if (!matriz) { perror("Error al asignar memoria"); exit(EXIT_FAILURE); }
-    for (int i = 0; i < n; i++) {
-        matriz[i] = (int*) malloc(n * sizeof(int));
-        if (!matriz[i]) { perror("Error al asignar memoria"); exit(EXIT_FAILURE); }
+// Kernel ingenuo por líneas de caché: cada C[i][j .. j+16) se acumula en
+// registros y se escribe una vez. j0 debe ser múltiplo de ELEMS_LINEA_INT
+// para que el hilo sea dueño de las líneas completas.
+void multiplicar_lineas(DatosHilo* datos, int i0, int i1, int j0, int j1) {
+    const Matriz* A = datos->A;
+    const Matriz* B = datos->B;
+    Matriz* C = datos->C;
+    for (int i = i0; i < i1; i++) {
+        for (int j = j0; j < j1; j += ELEMS_LINEA_INT) {
+            int ancho = j1 - j < ELEMS_LINEA_INT ? j1 - j : ELEMS_LINEA_INT;
+            producto_linea_int(datos->n, FILA(*A, i), B->datos + j, B->ld, FILA(*C, i) + j, ancho);
+        }
     }
-    return matriz;
-}
-
-void liberar_matriz(int** matriz, int n) {
-    for (int i = 0; i < n; i++) free(matriz[i]);
-    free(matriz);
 }
 
-void llenar_matriz(int** matriz, int n) {
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++)
-            matriz[i][j] = rand() % 10;
+// Calcula la baldosa [i0, i1) x [j0, j1) de C con el kernel elegido
+void multiplicar_baldosa(DatosHilo* datos, const Baldosa* b) {
+    if (datos->op->kernel != KERNEL_INGENUO) {
+        multiplicar_int(datos->op, b->i1 - b->i0, b->j1 - b->j0, datos->n,
+                        FILA(*datos->A, b->i0), datos->A->ld,
+                        datos->B->datos + b->j0, datos->B->ld,
+                        FILA(*datos->C, b->i0) + b->j0, datos->C->ld);
+        return;
+    }
+    multiplicar_lineas(datos, b->i0, b->i1, b->j0, b->j1);
 }
 
-void* multiplicar_paralelo(void* arg) {
+// Tarea de cada trabajador del pool: su rango de filas de C
+void multiplicar_paralelo(int id, void* arg) {
     DatosHilo* datos = (DatosHilo*) arg;
     struct timespec inicio, fin;
     clock_gettime(CLOCK_THREAD_CPUTIME_ID, &inicio);
 
+    if (datos->op->kernel != KERNEL_INGENUO) {
+        multiplicar_int(datos->op, datos->fin - datos->inicio, datos->n, datos->n,
+                        FILA(*datos->A, datos->inicio), datos->A->ld,
+                        datos->B->datos, datos->B->ld,
+                        FILA(*datos->C, datos->inicio), datos->C->ld);
+    } else {
+        // Las filas empiezan alineadas y ocupan ld (múltiplo de 16) enteros:
+        // un rango de filas siempre contiene líneas de C completas
+        multiplicar_lineas(datos, datos->inicio, datos->fin, 0, datos->n);
+    }
+    
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &fin);
+    datos->tiempo = (fin.tv_sec - inicio.tv_sec) + (fin.tv_nsec - inicio.tv_nsec) / 1e9;
+}
+
+// Versión anterior del kernel ingenuo (suma directa sobre C[i][j]), sólo
+// para --comparar
+void multiplicar_paralelo_original(int id, void* arg) {
+    DatosHilo* datos = (DatosHilo*) arg;
     for (int i = datos->inicio; i < datos->fin; i++)
         for (int j = 0; j < datos->n; j++) {
-            datos->C[i][j] = 0;
+            ELEM(*datos->C, i, j) = 0;
             for (int k = 0; k < datos->n; k++)
-                datos->C[i][j] += datos->A[i][k] * datos->B[k][j];
+                ELEM(*datos->C, i, j) += ELEM(*datos->A, i, k) * ELEM(*datos->B, k, j);
         }
-    
+}
+
+static double segundos_desde(const struct timespec* inicio) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - inicio->tv_sec) + (fin.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+// Modo --comparar: kernel ingenuo anterior frente al de líneas de caché con
+// 2, 4, 8, ... hasta max_hilos hilos (tiempo de pared medio por iteración)
+void comparar_kernels(const Matriz* A, const Matriz* B, int max_hilos, int iteraciones, int fijar) {
+    int n = A->n;
+    Matriz C_original = reservar_matriz(n);
+    Matriz C = reservar_matriz(n);
+    OpcionesGemm op;
+    opciones_gemm_defecto(&op, sizeof(int));
+
+    FILE* archivo = fopen("comparacion.csv", "a");
+    for (int hilos = 2; hilos <= max_hilos; hilos *= 2) {
+        PoolHilos* pool = crear_pool(hilos, fijar);
+        DatosHilo datos[hilos], datos_original[hilos];
+        int inicio_fila = 0;
+        for (int i = 0; i < hilos; i++) {
+            int filas = n / hilos + (i < n % hilos ? 1 : 0);
+            datos[i] = (DatosHilo) {inicio_fila, inicio_fila + filas, n, A, B, &C, &op, 0.0, NULL, 0, 0};
+            datos_original[i] = datos[i];
+            datos_original[i].C = &C_original;
+            inicio_fila += filas;
+        }
+
+        struct timespec t0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int it = 0; it < iteraciones; it++) {
+            ejecutar_pool(pool, multiplicar_paralelo_original, datos_original, sizeof(DatosHilo));
+        }
+        double t_original = segundos_desde(&t0) / iteraciones;
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int it = 0; it < iteraciones; it++) {
+            ejecutar_pool(pool, multiplicar_paralelo, datos, sizeof(DatosHilo));
+        }
+        double t_lineas = segundos_desde(&t0) / iteraciones;
+
+        int iguales = 1;
+        for (int i = 0; i < n && iguales; i++) {
+            iguales = memcmp(FILA(C, i), FILA(C_original, i), (size_t) n * sizeof(int)) == 0;
+        }
+        printf("Comparación: Tamaño: %d - Hilos: %d - Original: %.6f - Líneas: %.6f - Aceleración: %.2fx%s\n",
+               n, hilos, t_original, t_lineas, t_original / t_lineas, iguales ? "" : " - RESULTADOS DISTINTOS");
+        if (archivo != NULL) {
+            fprintf(archivo, "%d,%d,%.6f,%.6f\n", n, hilos, t_original, t_lineas);
+        }
+        destruir_pool(pool);
+    }
+    if (archivo != NULL) fclose(archivo);
+    liberar_matriz(&C_original);
+    liberar_matriz(&C);
+}
+
+// Tarea con robo de trabajo: baldosas de la cola propia y luego robadas
+void multiplicar_robo(int id, void* arg) {
+    DatosHilo* datos = (DatosHilo*) arg;
+    struct timespec inicio, fin;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &inicio);
+
+    Baldosa b;
+    datos->robos = 0;
+    datos->baldosas = 0;
+    while (siguiente_baldosa(datos->plan, id, &b, &datos->robos)) {
+        multiplicar_baldosa(datos, &b);
+        datos->baldosas++;
+    }
+
     clock_gettime(CLOCK_THREAD_CPUTIME_ID, &fin);
     datos->tiempo = (fin.tv_sec - inicio.tv_sec) + (fin.tv_nsec - inicio.tv_nsec) / 1e9;
-    pthread_exit(NULL);
+}
+
+// Datos de la inicialización NUMA de cada trabajador
+typedef struct {
+    int inicio, fin, num_hilos;
+    Matriz* A;
+    Matriz* B;
+    Matriz* C;
+    Matriz* replica;            // Copia de B que este hilo crea para su nodo (o NULL)
+    const TopologiaNuma* topo;
+    unsigned semilla;
+} DatosNuma;
+
+// Ancla al trabajador a su nodo y hace el primer toque de sus filas de A, B y C
+void inicializar_numa(int id, void* arg) {
+    DatosNuma* d = (DatosNuma*) arg;
+    fijar_hilo_nodo(d->topo, id, d->num_hilos);
+    llenar_filas(d->A, d->inicio, d->fin, d->semilla);
+    llenar_filas(d->B, d->inicio, d->fin, d->semilla * 31u + 7u);
+    for (int i = d->inicio; i < d->fin; i++) {
+        memset(FILA(*d->C, i), 0, (size_t) d->C->ld * sizeof(int));
+    }
+}
+
+// El primer hilo de cada nodo copia B completa en memoria local de su nodo
+void replicar_b(int id, void* arg) {
+    DatosNuma* d = (DatosNuma*) arg;
+    if (d->replica != NULL) {
+        copiar_filas(d->replica, d->B, 0, d->B->n);
+    }
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 4) {
-        fprintf(stderr, "Uso: %s <tama\u00f1o de la matriz> <n\u00famero de hilos> <n\u00famero de iteraciones>\n", argv[0]);
+    OpcionesGemm op;
+    opciones_gemm_defecto(&op, sizeof(int));
+    ModoNuma numa = NUMA_NO;
+    int fijar = 0, robo = 0, comparar = 0, alto = 0, ancho = 0, valido = argc >= 4;
+    for (int i = 4; valido && i < argc; i++) {
+        int r = parsear_opcion_gemm(argv[i], &op);
+        if (r == 0 && strcmp(argv[i], "--fijar") == 0) {
+            fijar = 1;
+        } else if (r == 0 && strcmp(argv[i], "--comparar") == 0) {
+            comparar = 1;
+        } else if (r == 0 && strcmp(argv[i], "--planificador=robo") == 0) {
+            robo = 1;
+        } else if (r == 0 && strcmp(argv[i], "--planificador=estatico") == 0) {
+            robo = 0;
+        } else if (r == 0 && strncmp(argv[i], "--numa=", 7) == 0) {
+            if (parsear_modo_numa(argv[i] + 7, &numa) != 0) {
+                fprintf(stderr, "Modo NUMA desconocido: %s\n", argv[i] + 7);
+                valido = 0;
+            }
+        } else if (r == 0 && strncmp(argv[i], "--baldosa=", 10) == 0) {
+            if (parsear_baldosa(argv[i] + 10, &alto, &ancho) != 0) {
+                fprintf(stderr, "Baldosa inv\u00e1lida: %s\n", argv[i] + 10);
+                valido = 0;
+            }
+        } else if (r == 0) {
+            fprintf(stderr, "Opci\u00f3n desconocida: %s\n", argv[i]);
+            valido = 0;
+        } else if (r < 0) {
+            valido = 0;
+        }
+    }
+    if (!valido) {
+        fprintf(stderr, "Uso: %s <tama\u00f1o de la matriz> <n\u00famero de hilos> <n\u00famero de iteraciones> " OPCIONES_GEMM_USO " [--fijar] [--comparar] [--planificador=estatico|robo] [--baldosa=FxC]"
+                        " [--numa=no|primer-toque|intercalado|replicado]\n", argv[0]);
         return EXIT_FAILURE;
     }
 
@@ -63,31 +235,81 @@ int main(int argc, char* argv[]) {
 
     srand(time(NULL));
 
-    int** A = reservar_matriz(n);
-    int** B = reservar_matriz(n);
-    int** C = reservar_matriz(n);
-    llenar_matriz(A, n);
-    llenar_matriz(B, n);
+    TopologiaNuma topo;
+    detectar_topologia(&topo);
+
+    Matriz A = reservar_matriz(n);
+    Matriz B = numa == NUMA_INTERCALADO ? reservar_matriz_intercalada(n, &topo) : reservar_matriz(n);
+    Matriz C = reservar_matriz(n);
+    if (numa == NUMA_NO || comparar) {
+        llenar_matriz(&A);
+        llenar_matriz(&B);
+    }
 
-    pthread_t hilos[num_hilos];
+    if (comparar) {
+        comparar_kernels(&A, &B, num_hilos, iteraciones, fijar);
+        liberar_topologia(&topo);
+        liberar_matriz(&A);
+        liberar_matriz(&B);
+        liberar_matriz(&C);
+        return EXIT_SUCCESS;
+    }
+
+    // Los hilos se crean una sola vez; --fijar los ancla a CPUs distintas
+    // (en modo NUMA el anclaje lo hace inicializar_numa, nodo por nodo)
+    PoolHilos* pool = crear_pool(num_hilos, fijar && numa == NUMA_NO);
     DatosHilo datos[num_hilos];
+    DatosNuma datos_numa[num_hilos];
+    Matriz replicas[NUMA_MAX_NODOS];
+    char reparto[256] = "";
+    PlanificadorRobo* plan = robo ? crear_planificador(num_hilos) : NULL;
+    if (robo && alto == 0) {
+        baldosa_defecto(n, num_hilos, &alto, &ancho);
+    }
+    // Baldosas de líneas completas: dos hilos nunca escriben la misma línea de C
+    ancho = (ancho + ELEMS_LINEA_INT - 1) / ELEMS_LINEA_INT * ELEMS_LINEA_INT;
 
     int filas_por_hilo = n / num_hilos, filas_extra = n % num_hilos, inicio_fila = 0;
 
     for (int i = 0; i < num_hilos; i++) {
         int filas_a_asignar = filas_por_hilo + (i < filas_extra ? 1 : 0);
-        datos[i] = (DatosHilo) {inicio_fila, inicio_fila + filas_a_asignar, n, A, B, C, 0.0};
+        datos[i] = (DatosHilo) {inicio_fila, inicio_fila + filas_a_asignar, n, &A, &B, &C, &op, 0.0, plan, 0, 0};
+        datos_numa[i] = (DatosNuma) {datos[i].inicio, datos[i].fin, num_hilos, &A, &B, &C,
+                                     NULL, &topo, (unsigned) time(NULL)};
         inicio_fila += filas_a_asignar;
     }
 
+    // Primer toque en paralelo con el mismo reparto de filas que el cálculo
+    if (numa != NUMA_NO) {
+        ejecutar_pool(pool, inicializar_numa, datos_numa, sizeof(DatosNuma));
+
+        if (numa == NUMA_REPLICADO) {
+            for (int i = 0; i < num_hilos; i++) {
+                int nodo = nodo_de_hilo(&topo, i, num_hilos);
+                if (i == 0 || nodo != nodo_de_hilo(&topo, i - 1, num_hilos)) {
+                    replicas[nodo] = reservar_matriz(n);
+                    datos_numa[i].replica = &replicas[nodo];
+                }
+                datos[i].B = &replicas[nodo];
+            }
+            ejecutar_pool(pool, replicar_b, datos_numa, sizeof(DatosNuma));
+        }
+
+        describir_reparto(&topo, num_hilos, reparto, sizeof(reparto));
+        printf("NUMA: modo %s - nodos %d - hilos por nodo %s\n",
+               nombre_modo_numa(numa), topo.num_nodos, reparto);
+    }
+
     for (int it = 0; it < iteraciones; it++) {
         double tiempo_total = 0.0;
 
-        for (int i = 0; i < num_hilos; i++) {
-            pthread_create(&hilos[i], NULL, multiplicar_paralelo, (void*)&datos[i]);
+        if (robo) {
+            repartir_baldosas(plan, n, n, alto, ancho);
+            ejecutar_pool(pool, multiplicar_robo, datos, sizeof(DatosHilo));
+        } else {
+            ejecutar_pool(pool, multiplicar_paralelo, datos, sizeof(DatosHilo));
         }
         for (int i = 0; i < num_hilos; i++) {
-            pthread_join(hilos[i], NULL);
             tiempo_total += datos[i].tiempo;
         }
 
@@ -96,15 +318,41 @@ int main(int argc, char* argv[]) {
 
         FILE* archivo = fopen("resultados.csv", "a");
         if (archivo != NULL) {
-            fprintf(archivo, "%d,%d,%d,%.6f\n", n, it + 1, num_hilos, tiempo_promedio);
+            // En modo NUMA se agrega la distribución: modo,nodos,hilos por nodo
+            if (numa != NUMA_NO)
+                fprintf(archivo, "%d,%d,%d,%.6f,%s,%d,%s\n", n, it + 1, num_hilos, tiempo_promedio,
+                        nombre_modo_numa(numa), topo.num_nodos, reparto);
+            else
+                fprintf(archivo, "%d,%d,%d,%.6f\n", n, it + 1, num_hilos, tiempo_promedio);
             fclose(archivo);
         } else {
             perror("Error al abrir el archivo CSV");
         }
+
+        // Con robo de trabajo: tiempo, robos y baldosas de cada hilo
+        if (robo) {
+            FILE* detalle = fopen("robos.csv", "a");
+            for (int i = 0; i < num_hilos; i++) {
+                printf("  Hilo %d -> Tiempo: %.6f - Robos: %ld - Baldosas: %d\n",
+                       i, datos[i].tiempo, datos[i].robos, datos[i].baldosas);
+                if (detalle != NULL)
+                    fprintf(detalle, "%d,%d,%d,%d,%.6f,%ld,%d\n", n, it + 1, num_hilos, i,
+                            datos[i].tiempo, datos[i].robos, datos[i].baldosas);
+            }
+            if (detalle != NULL) fclose(detalle);
+        }
     }
 
-    liberar_matriz(A, n);
-    liberar_matriz(B, n);
-    liberar_matriz(C, n);
+    destruir_pool(pool);
+    if (plan) destruir_planificador(plan);
+    if (numa == NUMA_REPLICADO) {
+        for (int i = 0; i < num_hilos; i++) {
+            if (datos_numa[i].replica != NULL) liberar_matriz(datos_numa[i].replica);
+        }
+    }
+    liberar_topologia(&topo);
+    liberar_matriz(&A);
+    liberar_matriz(&B);
+    liberar_matriz(&C);
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "matrix_io.h"
+
+static void report(MPI_Comm comm, const char* path, const char* reason) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (rank == 0) {
+        fprintf(stderr, "Error: %s: %s\n", path, reason);
+    }
+}
+
+int matrix_file_open(const char* path, MPI_Comm comm, MatrixFile* file) {
+    if (MPI_File_open(comm, path, MPI_MODE_RDONLY, MPI_INFO_NULL, &file->fh) != MPI_SUCCESS) {
+        report(comm, path, "cannot open file");
+        return -1;
+    }
+
+    // Todos leen la cabecera (unos pocos bytes) en la misma operación colectiva
+    MatrixFileHeader* h = &file->header;
+    MPI_File_read_at_all(file->fh, 0, h, sizeof(*h), MPI_BYTE, MPI_STATUS_IGNORE);
+
+    const char* reason = NULL;
+    if (memcmp(h->magic, MATRIX_FILE_MAGIC, sizeof(h->magic)) != 0) {
+        reason = "not a matrix file (bad magic)";
+    } else if (h->version != MATRIX_FILE_VERSION) {
+        reason = "unsupported format version";
+    } else if (h->byte_order != MATRIX_FILE_BYTE_ORDER) {
+        reason = "file was written with a different byte order";
+    } else if (h->dtype != DTYPE_FLOAT64) {
+        reason = "only float64 matrices are supported";
+    } else if (h->layout != LAYOUT_ROW_MAJOR) {
+        reason = "only row-major layout is supported";
+    } else if (h->data_offset < sizeof(*h)) {
+        reason = "corrupt header (data offset)";
+    }
+    if (reason) {
+        report(comm, path, reason);
+        MPI_File_close(&file->fh);
+        return -1;
+    }
+    return 0;
+}
+
+int matrix_file_create(const char* path, MPI_Comm comm, int rows, int cols, MatrixFile* file) {
+    // Un archivo previo más largo dejaría basura al final
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (rank == 0) {
+        MPI_File_delete(path, MPI_INFO_NULL);
+    }
+    MPI_Barrier(comm);
+
+    if (MPI_File_open(comm, path, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL,
+                      &file->fh) != MPI_SUCCESS) {
+        report(comm, path, "cannot create file");
+        return -1;
+    }
+
+    MatrixFileHeader* h = &file->header;
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, MATRIX_FILE_MAGIC, sizeof(h->magic));
+    h->version = MATRIX_FILE_VERSION;
+    h->dtype = DTYPE_FLOAT64;
+    h->layout = LAYOUT_ROW_MAJOR;
+    h->byte_order = MATRIX_FILE_BYTE_ORDER;
+    h->rows = (uint64_t) rows;
+    h->cols = (uint64_t) cols;
+    h->data_offset = MATRIX_FILE_DATA_OFFSET;
+
+    // Sólo el rango 0 escribe la cabecera; el resto participa con 0 bytes
+    MPI_File_write_at_all(file->fh, 0, h, rank == 0 ? (int) sizeof(*h) : 0, MPI_BYTE,
+                          MPI_STATUS_IGNORE);
+    MPI_File_set_size(file->fh, (MPI_Offset) (h->data_offset + h->rows * h->cols * sizeof(double)));
+    return 0;
+}
+
+void matrix_file_close(MatrixFile* file) {
+    MPI_File_close(&file->fh);
+}
+
+// Vista del archivo que expone sólo el bloque pedido (vacía si no tiene elementos)
+static void set_block_view(MatrixFile* file, int r0, int r1, int c0, int c1) {
+    const MatrixFileHeader* h = &file->header;
+    MPI_Datatype block;
+    int sizes[2] = {(int) h->rows, (int) h->cols};
+    int subsizes[2] = {r1 - r0, c1 - c0};
+    int starts[2] = {r0, c0};
+    if (subsizes[0] <= 0 || subsizes[1] <= 0) {
+        // Un subarreglo no puede tener tamaño 0: se usa un tipo vacío
+        MPI_Type_contiguous(0, MPI_DOUBLE, &block);
+    } else {
+        MPI_Type_create_subarray(2, sizes, subsizes, starts, MPI_ORDER_C, MPI_DOUBLE, &block);
+    }
+    MPI_Type_commit(&block);
+    MPI_File_set_view(file->fh, (MPI_Offset) h->data_offset, MPI_DOUBLE, block, "native",
+                      MPI_INFO_NULL);
+    MPI_Type_free(&block);
+}
+
+int matrix_file_read_block(MatrixFile* file, int r0, int r1, int c0, int c1, double* buf) {
+    set_block_view(file, r0, r1, c0, c1);
+    int count = r1 > r0 && c1 > c0 ? (r1 - r0) * (c1 - c0) : 0;
+    MPI_Status status;
+    int rc = MPI_File_read_at_all(file->fh, 0, buf, count, MPI_DOUBLE, &status);
+    int got;
+    MPI_Get_count(&status, MPI_DOUBLE, &got);
+    return rc == MPI_SUCCESS && got == count ? 0 : -1;
+}
+
+int matrix_file_write_block(MatrixFile* file, int r0, int r1, int c0, int c1, const double* buf) {
+    set_block_view(file, r0, r1, c0, c1);
+    int count = r1 > r0 && c1 > c0 ? (r1 - r0) * (c1 - c0) : 0;
+    int rc = MPI_File_write_at_all(file->fh, 0, buf, count, MPI_DOUBLE, MPI_STATUS_IGNORE);
+    return rc == MPI_SUCCESS ? 0 : -1;
+}
@@ -0,0 +1,57 @@
+#ifndef MATRIX_IO_H_
+#define MATRIX_IO_H_
+
+#include <mpi.h>
+#include <stdint.h>
+
+/*
+ * Formato binario de matrices para MPI-IO. Cabecera fija al inicio del
+ * archivo y datos a partir de MATRIX_FILE_DATA_OFFSET (alineado a bloque de
+ * sistema de archivos), por filas y sin relleno:
+ *
+ *   magic "HPCMAT01" | versión | tipo | disposición | marca de orden de bytes
+ *   | filas | columnas | desplazamiento de los datos
+ *
+ * Cada rango lee o escribe sólo su bloque [r0, r1) x [c0, c1) con una vista
+ * de subarreglo y las operaciones colectivas MPI_File_read_at_all /
+ * MPI_File_write_at_all.
+ */
+#define MATRIX_FILE_MAGIC "HPCMAT01"
+#define MATRIX_FILE_VERSION 1
+#define MATRIX_FILE_DATA_OFFSET 4096
+#define MATRIX_FILE_BYTE_ORDER 0x01020304u
+
+typedef enum { DTYPE_FLOAT64 = 1, DTYPE_INT32 = 2 } MatrixDtype;
+typedef enum { LAYOUT_ROW_MAJOR = 0 } MatrixLayout;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t dtype;
+    uint32_t layout;
+    uint32_t byte_order;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t data_offset;
+} MatrixFileHeader;
+
+typedef struct {
+    MPI_File fh;
+    MatrixFileHeader header;
+} MatrixFile;
+
+// Abre un archivo existente y valida la cabecera (colectiva sobre comm).
+// Devuelve 0 si es válido; en caso contrario el rango 0 imprime el motivo.
+int matrix_file_open(const char* path, MPI_Comm comm, MatrixFile* file);
+
+// Crea (o trunca) un archivo float64 por filas de rows x cols (colectiva)
+int matrix_file_create(const char* path, MPI_Comm comm, int rows, int cols, MatrixFile* file);
+
+void matrix_file_close(MatrixFile* file);
+
+// Lee / escribe el bloque [r0, r1) x [c0, c1) en buf (por filas, ld = c1 - c0).
+// Colectivas: todos los rangos del comunicador deben llamarlas (con bloques vacíos si hace falta).
+int matrix_file_read_block(MatrixFile* file, int r0, int r1, int c0, int c1, double* buf);
+int matrix_file_write_block(MatrixFile* file, int r0, int r1, int c0, int c1, const double* buf);
+
+#endif /* MATRIX_IO_H_ */
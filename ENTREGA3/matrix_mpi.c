@@ -1,9 +1,26 @@
 #include <mpi.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
 
+#include "../comun/gemm.h"
+#include "matrix_io.h"
+#include "mpi_profile.h"
+#include "partition.h"
+
+// Archivos de entrada y salida en el formato de matrix_io.h (NULL: no se usan)
+typedef struct {
+    const char* input_a;
+    const char* input_b;
+    const char* output_c;
+    const char* save_prefix;    // Guarda A y B generadas en <prefijo>_A.mat / _B.mat
+} IoOptions;
+
+// Distribución de los datos (--mode=...)
+typedef enum { MODE_ROWS, MODE_SUMMA, MODE_PIPELINE, MODE_SHARED } RunMode;
+
 void initialize_matrices(double* A, double* B, int n) {
     srand(time(NULL));
     for (int i = 0; i < n * n; i++) {
@@ -12,12 +29,39 @@ void initialize_matrices(double* A, double* B, int n) {
     }
 }
 
-void matrix_multiply_mpi(double* A, double* B, double* C, int n, int rank, int size) {
-    int rows_per_process = n / size;
-    int start_row = rank * rows_per_process;
-    int end_row = (rank == size - 1) ? n : start_row + rows_per_process;
+/*
+ * Producto local C = A * B (m x k por k x n) repartido en franjas de filas
+ * entre `threads` hilos OpenMP del rango. Sólo el hilo principal llama a MPI
+ * (MPI_THREAD_FUNNELED). Compilado sin -fopenmp se ejecuta en serie.
+ */
+void local_multiply(const OpcionesGemm* op, int threads, int m, int n, int k,
+                    const double* A, int lda, const double* B, int ldb, double* C, int ldc) {
+    MPI_Pcontrol(PROFILE_COMPUTE_BEGIN);
+    #pragma omp parallel for num_threads(threads) schedule(static)
+    for (int t = 0; t < threads; t++) {
+        int i0 = (int) ((long) m * t / threads), i1 = (int) ((long) m * (t + 1) / threads);
+        if (i1 > i0) {
+            multiplicar_double(op, i1 - i0, n, k, A + (size_t) i0 * lda, lda, B, ldb,
+                               C + (size_t) i0 * ldc, ldc);
+        }
+    }
+    MPI_Pcontrol(PROFILE_COMPUTE_END);
+}
+
+// Calcula las filas del rango según el reparto (el mismo que usa la recolección)
+void matrix_multiply_mpi(double* A, double* B, double* C, int n, const RowPartition* part,
+                         int rank, const OpcionesGemm* op, int threads) {
+    int start_row = part->start[rank], end_row = part->start[rank + 1];
     
+    if (op->kernel != KERNEL_INGENUO) {
+        local_multiply(op, threads, end_row - start_row, n, n, A + (size_t)start_row * n, n,
+                       B, n, C + (size_t)start_row * n, n);
+        return;
+    }
+
     // Multiplicación local
+    MPI_Pcontrol(PROFILE_COMPUTE_BEGIN);
+    #pragma omp parallel for num_threads(threads) schedule(static)
     for (int i = start_row; i < end_row; i++) {
         for (int j = 0; j < n; j++) {
             C[i*n + j] = 0.0;
@@ -26,6 +70,662 @@ void matrix_multiply_mpi(double* A, double* B, double* C, int n, int rank, int s
             }
         }
     }
+    MPI_Pcontrol(PROFILE_COMPUTE_END);
+}
+
+/*
+ * Modo SUMMA: malla 2D de procesos (MPI_Cart_create) en la que cada rango
+ * guarda sólo su bloque de A, B y C. En cada paso el dueño de un panel de
+ * columnas de A lo difunde por su fila de la malla y el dueño del panel de
+ * filas de B por su columna; cada rango acumula C_loc += A_panel * B_panel.
+ */
+#define SUMMA_PANEL_DEFAULT 256   // También el ancho de panel del modo pipeline
+
+// Inicio del bloque idx cuando n se reparte entre parts
+static int block_start(int n, int parts, int idx) {
+    return (int) ((long) n * idx / parts);
+}
+
+// Bloque (de parts) que contiene el índice global i
+static int block_owner(int n, int parts, int i) {
+    int owner = (int) (((long) i * parts + parts - 1) / n);
+    while (owner > 0 && block_start(n, parts, owner) > i) owner--;
+    while (owner < parts - 1 && block_start(n, parts, owner + 1) <= i) owner++;
+    return owner;
+}
+
+// Valor del elemento (i, j) de la matriz `which` (0 = A, 1 = B) en [0, 1):
+// cada rango genera su bloque sin que ningún proceso tenga la matriz completa
+static double element_value(uint64_t seed, int which, long i, long j) {
+    uint64_t x = seed ^ ((uint64_t) which << 62) ^ ((uint64_t) i << 31) ^ (uint64_t) j;
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return (double) (x >> 11) * 0x1.0p-53;
+}
+
+static void* checked_malloc(size_t bytes) {
+    void* p = malloc(bytes > 0 ? bytes : 1);
+    if (!p) {
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        printf("Error: Memory allocation failed on process %d\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    return p;
+}
+
+// Lee el bloque [r0, r1) x [c0, c1) de una matriz n x n (colectiva)
+static void load_block(const char* path, int n, int r0, int r1, int c0, int c1, double* buf) {
+    MatrixFile file;
+    if (matrix_file_open(path, MPI_COMM_WORLD, &file) != 0) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (file.header.rows != (uint64_t) n || file.header.cols != (uint64_t) n) {
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        if (rank == 0) fprintf(stderr, "Error: %s is %llux%llu, expected %dx%d\n", path,
+                (unsigned long long) file.header.rows, (unsigned long long) file.header.cols, n, n);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (matrix_file_read_block(&file, r0, r1, c0, c1, buf) != 0) {
+        fprintf(stderr, "Error: short read from %s\n", path);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    matrix_file_close(&file);
+}
+
+// Escribe el bloque [r0, r1) x [c0, c1) de una matriz n x n (colectiva)
+static void store_block(const char* path, int n, int r0, int r1, int c0, int c1, const double* buf) {
+    MatrixFile file;
+    if (matrix_file_create(path, MPI_COMM_WORLD, n, n, &file) != 0 ||
+        matrix_file_write_block(&file, r0, r1, c0, c1, buf) != 0) {
+        fprintf(stderr, "Error: cannot write %s\n", path);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    matrix_file_close(&file);
+}
+
+// Guarda A y B en <prefijo>_A.mat y <prefijo>_B.mat (cada rango su bloque)
+static void save_inputs(const char* prefix, int n, int r0, int r1, int c0, int c1,
+                        const double* A_block, const double* B_block) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s_A.mat", prefix);
+    store_block(path, n, r0, r1, c0, c1, A_block);
+    snprintf(path, sizeof(path), "%s_B.mat", prefix);
+    store_block(path, n, r0, r1, c0, c1, B_block);
+}
+
+static void print_kernel(const OpcionesGemm* op) {
+    if (op->kernel == KERNEL_EMPAQUETADO) {
+        printf("Kernel: %s (%s)\n", nombre_kernel(op->kernel), descripcion_empaquetado_double());
+    } else {
+        printf("Kernel: %s\n", nombre_kernel(op->kernel));
+    }
+}
+
+void summa_multiply(double* A_loc, double* B_loc, double* C_loc, int n,
+                    MPI_Comm grid, const int dims[2], const int coords[2],
+                    int panel, const OpcionesGemm* op, int threads) {
+    MPI_Comm row_comm, col_comm;
+    int keep_cols[2] = {0, 1}, keep_rows[2] = {1, 0};
+    MPI_Cart_sub(grid, keep_cols, &row_comm);   // Rango = coordenada de columna
+    MPI_Cart_sub(grid, keep_rows, &col_comm);   // Rango = coordenada de fila
+
+    int pr = dims[0], pc = dims[1];
+    int my_row = coords[0], my_col = coords[1];
+    int m_loc = block_start(n, pr, my_row + 1) - block_start(n, pr, my_row);
+    int n_loc = block_start(n, pc, my_col + 1) - block_start(n, pc, my_col);
+    int k_loc_a = block_start(n, pc, my_col + 1) - block_start(n, pc, my_col);
+
+    double* A_panel = checked_malloc((size_t) m_loc * panel * sizeof(double));
+    double* B_panel = checked_malloc((size_t) panel * n_loc * sizeof(double));
+    double* C_tmp = checked_malloc((size_t) m_loc * n_loc * sizeof(double));
+
+    int first = 1;
+    for (int k = 0; k < n; ) {
+        // El panel no cruza el borde de un bloque de A (columnas) ni de B (filas)
+        int a_owner = block_owner(n, pc, k), b_owner = block_owner(n, pr, k);
+        int k_end = k + panel < n ? k + panel : n;
+        if (block_start(n, pc, a_owner + 1) < k_end) k_end = block_start(n, pc, a_owner + 1);
+        if (block_start(n, pr, b_owner + 1) < k_end) k_end = block_start(n, pr, b_owner + 1);
+        int w = k_end - k;
+
+        if (my_col == a_owner) {
+            int offset = k - block_start(n, pc, a_owner);
+            for (int i = 0; i < m_loc; i++) {
+                memcpy(A_panel + (size_t) i * w, A_loc + (size_t) i * k_loc_a + offset,
+                       w * sizeof(double));
+            }
+        }
+        MPI_Bcast(A_panel, m_loc * w, MPI_DOUBLE, a_owner, row_comm);
+
+        // Las filas del panel de B son contiguas en B_loc: se difunden sin copiar
+        double* B_rows = B_panel;
+        if (my_row == b_owner) {
+            B_rows = B_loc + (size_t) (k - block_start(n, pr, b_owner)) * n_loc;
+        }
+        MPI_Bcast(B_rows, w * n_loc, MPI_DOUBLE, b_owner, col_comm);
+
+        if (first) {
+            local_multiply(op, threads, m_loc, n_loc, w, A_panel, w, B_rows, n_loc, C_loc, n_loc);
+            first = 0;
+        } else {
+            MPI_Pcontrol(PROFILE_COMPUTE_BEGIN);
+            local_multiply(op, threads, m_loc, n_loc, w, A_panel, w, B_rows, n_loc, C_tmp, n_loc);
+            #pragma omp parallel for num_threads(threads) schedule(static)
+            for (size_t i = 0; i < (size_t) m_loc * n_loc; i++) {
+                C_loc[i] += C_tmp[i];
+            }
+            MPI_Pcontrol(PROFILE_COMPUTE_END);
+        }
+        k = k_end;
+    }
+
+    free(A_panel);
+    free(B_panel);
+    free(C_tmp);
+    MPI_Comm_free(&row_comm);
+    MPI_Comm_free(&col_comm);
+}
+
+// Ejecución completa del modo SUMMA: bloques locales, tiempo y verificación
+int run_summa(int n, int rank, int size, int panel, const OpcionesGemm* op, int threads,
+              const IoOptions* io) {
+    int dims[2] = {0, 0}, periods[2] = {0, 0}, coords[2];
+    MPI_Comm grid;
+    MPI_Dims_create(size, 2, dims);
+    MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 0, &grid);
+    MPI_Cart_coords(grid, rank, 2, coords);
+
+    int r0 = block_start(n, dims[0], coords[0]), r1 = block_start(n, dims[0], coords[0] + 1);
+    int c0 = block_start(n, dims[1], coords[1]), c1 = block_start(n, dims[1], coords[1] + 1);
+    int m_loc = r1 - r0, n_loc = c1 - c0;
+
+    // A_loc y B_loc: filas [r0, r1) x columnas [c0, c1) de su matriz
+    double* A_loc = checked_malloc((size_t) m_loc * n_loc * sizeof(double));
+    double* B_loc = checked_malloc((size_t) m_loc * n_loc * sizeof(double));
+    double* C_loc = checked_malloc((size_t) m_loc * n_loc * sizeof(double));
+
+    // Con archivos de entrada cada rango lee sólo sus bloques (MPI-IO colectivo)
+    uint64_t seed = (uint64_t) time(NULL);
+    int generated = !io->input_a && !io->input_b;
+    MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    for (int i = 0; i < m_loc; i++) {
+        for (int j = 0; j < n_loc; j++) {
+            A_loc[(size_t) i * n_loc + j] = element_value(seed, 0, r0 + i, c0 + j);
+            B_loc[(size_t) i * n_loc + j] = element_value(seed, 1, r0 + i, c0 + j);
+        }
+    }
+    if (io->input_a) load_block(io->input_a, n, r0, r1, c0, c1, A_loc);
+    if (io->input_b) load_block(io->input_b, n, r0, r1, c0, c1, B_loc);
+    if (io->save_prefix) save_inputs(io->save_prefix, n, r0, r1, c0, c1, A_loc, B_loc);
+
+    if (rank == 0) {
+        printf("Starting matrix multiplication: %dx%d with %d processes\n", n, n, size);
+        printf("Mode: summa - grid %dx%d - panel %d - local block %dx%d\n",
+               dims[0], dims[1], panel, m_loc, n_loc);
+        print_kernel(op);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start_time = MPI_Wtime();
+    summa_multiply(A_loc, B_loc, C_loc, n, grid, dims, coords, panel, op, threads);
+    MPI_Barrier(MPI_COMM_WORLD);
+    double end_time = MPI_Wtime();
+
+    // Verificación sin comunicación: cada rango recalcula unas entradas de su
+    // bloque generando la fila de A y la columna de B correspondientes
+    double max_error = 0.0;
+    for (int s = 0; s < 4 && generated && m_loc > 0 && n_loc > 0; s++) {
+        int i = (int) ((long) s * (m_loc - 1) / 3), j = (int) ((long) (3 - s) * (n_loc - 1) / 3);
+        double ref = 0.0;
+        for (int k = 0; k < n; k++) {
+            ref += element_value(seed, 0, r0 + i, k) * element_value(seed, 1, k, c0 + j);
+        }
+        double err = C_loc[(size_t) i * n_loc + j] - ref;
+        if (err < 0) err = -err;
+        if (err > max_error) max_error = err;
+    }
+    double global_error;
+    MPI_Reduce(&max_error, &global_error, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (io->output_c) store_block(io->output_c, n, r0, r1, c0, c1, C_loc);
+
+    if (rank == 0) {
+        if (generated)
+            printf("Verification: max error %.3e\n", global_error);
+        printf("Matrix size: %d, Processes: %d, Time: %.6f seconds\n",
+               n, size, end_time - start_time);
+    }
+
+    free(A_loc);
+    free(B_loc);
+    free(C_loc);
+    MPI_Comm_free(&grid);
+    return 0;
+}
+
+/*
+ * Reparto de filas de los modos rows y pipeline (partition.h). Con
+ * --weights=calibrate cada rango mide sus GFLOP/s en un producto pequeño y las
+ * franjas son proporcionales a esa velocidad; con --weights=FILE los pesos se
+ * leen de un archivo (uno por rango).
+ */
+#define CALIBRATION_SIZE 256
+
+// GFLOP/s de cada rango con el mismo kernel e hilos que el producto real
+static void calibrate_weights(const OpcionesGemm* op, int threads, int n, double* weights) {
+    int m = n < CALIBRATION_SIZE ? n : CALIBRATION_SIZE;
+    double* A = checked_malloc((size_t) m * m * sizeof(double));
+    double* B = checked_malloc((size_t) m * m * sizeof(double));
+    double* C = checked_malloc((size_t) m * m * sizeof(double));
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < m; j++) {
+            A[(size_t) i * m + j] = element_value(1, 0, i, j);
+            B[(size_t) i * m + j] = element_value(1, 1, i, j);
+        }
+    }
+
+    // La mejor de 3 ejecuciones (la primera calienta cachés y páginas)
+    double best = 0.0;
+    for (int rep = 0; rep < 3; rep++) {
+        double t0 = MPI_Wtime();
+        local_multiply(op, threads, m, m, m, A, m, B, m, C, m);
+        double t = MPI_Wtime() - t0;
+        if (rep == 0 || t < best) best = t;
+    }
+    double rate = best > 0.0 ? 2.0 * m * m * m / best / 1e9 : 1.0;
+    MPI_Allgather(&rate, 1, MPI_DOUBLE, weights, 1, MPI_DOUBLE, MPI_COMM_WORLD);
+
+    free(A);
+    free(B);
+    free(C);
+}
+
+// Construye el reparto (colectiva). Devuelve -1, con el motivo impreso en el
+// rango 0, si los pesos no sirven.
+static int build_partition(RowPartition* part, int n, int rank, int size, const char* weights_arg,
+                           const OpcionesGemm* op, int threads) {
+    if (weights_arg == NULL) {
+        partition_uniform(part, n, size);
+        return 0;
+    }
+
+    double* weights = checked_malloc(size * sizeof(double));
+    int calibrated = strcmp(weights_arg, "calibrate") == 0;
+    if (calibrated) {
+        calibrate_weights(op, threads, n, weights);
+    } else {
+        int count = 0;
+        if (rank == 0) {
+            count = partition_read_weights(weights_arg, size, weights);
+            if (count < 0) {
+                fprintf(stderr, "Error: cannot open weights file %s\n", weights_arg);
+            } else if (count < size) {
+                fprintf(stderr, "Error: %s has %d weights, %d processes need one each\n",
+                        weights_arg, count, size);
+            }
+        }
+        MPI_Bcast(&count, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (count < size) {
+            free(weights);
+            return -1;
+        }
+        MPI_Bcast(weights, size, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    }
+
+    int status = partition_weighted(part, n, size, weights);
+    if (rank == 0) {
+        if (status != 0) {
+            fprintf(stderr, "Error: weights must be non-negative and not all zero\n");
+        } else {
+            printf("Partition: weighted (%s) - rows", calibrated ? "calibrated GFLOP/s" : weights_arg);
+            for (int r = 0; r < size; r++) {
+                printf("%s%d", r ? "/" : " ", PARTITION_ROWS(part, r));
+            }
+            printf("\n");
+        }
+    }
+    free(weights);
+    return status;
+}
+
+// Filas, tiempo de cómputo y GFLOP/s alcanzados por cada rango (colectiva)
+static void report_rank_rates(const RowPartition* part, int n, int rank, double compute_time) {
+    char host[MPI_MAX_PROCESSOR_NAME];
+    int len;
+    memset(host, 0, sizeof(host));
+    MPI_Get_processor_name(host, &len);
+
+    double* times = NULL;
+    char* hosts = NULL;
+    if (rank == 0) {
+        times = checked_malloc(part->parts * sizeof(double));
+        hosts = checked_malloc((size_t) part->parts * MPI_MAX_PROCESSOR_NAME);
+    }
+    MPI_Gather(&compute_time, 1, MPI_DOUBLE, times, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Gather(host, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, hosts, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+               0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        for (int r = 0; r < part->parts; r++) {
+            double flops = 2.0 * PARTITION_ROWS(part, r) * n * n;
+            printf("Rank %d (%s): rows %d - compute %.6f s - %.2f GFLOP/s\n", r,
+                   hosts + (size_t) r * MPI_MAX_PROCESSOR_NAME, PARTITION_ROWS(part, r), times[r],
+                   times[r] > 0.0 ? flops / times[r] / 1e9 : 0.0);
+        }
+        free(times);
+        free(hosts);
+    }
+}
+
+/*
+ * Modo pipeline: B y C se procesan por paneles de columnas. Mientras se
+ * multiplica el panel k ya está en vuelo el MPI_Ibcast del panel k + 1 y el
+ * MPI_Iallgatherv del resultado del panel k - 1 (dos buffers de cada tipo).
+ * Cada rango recibe sólo sus filas de A (MPI_Scatterv).
+ */
+#define PIPELINE_CHUNKS 4   // Trozos de filas por panel entre llamadas a MPI_Testall
+
+typedef struct {
+    MPI_Request bcast;      // Panel de B
+    MPI_Request gather;     // Panel de C
+    double* B_panel;        // n x w
+    double* C_local;        // filas propias x w
+    double* C_panel;        // n x w, resultado reunido
+    int* counts;            // Cuentas y desplazamientos del Iallgatherv en vuelo
+    int* displs;
+    int j0, w;              // Panel de B en el slot
+    int c_j0, c_w;          // Panel de C que se está reuniendo
+} PipelineSlot;
+
+// Copia las columnas [j0, j0 + w) de M (n x n) en un panel contiguo n x w
+static void pack_columns(const double* M, int n, int j0, int w, double* panel) {
+    for (int i = 0; i < n; i++) {
+        memcpy(panel + (size_t) i * w, M + (size_t) i * n + j0, w * sizeof(double));
+    }
+}
+
+static void unpack_columns(double* M, int n, int j0, int w, const double* panel) {
+    for (int i = 0; i < n; i++) {
+        memcpy(M + (size_t) i * n + j0, panel + (size_t) i * w, w * sizeof(double));
+    }
+}
+
+int run_pipeline(int n, int rank, int size, int panel, const RowPartition* part,
+                 const OpcionesGemm* op, int threads) {
+    if (panel > n) panel = n;
+    int m_loc = PARTITION_ROWS(part, rank);
+    int num_panels = (n + panel - 1) / panel;
+
+    int* counts = checked_malloc(size * sizeof(int));
+    int* displs = checked_malloc(size * sizeof(int));
+
+    double* A = NULL;
+    double* B = NULL;
+    double* C = checked_malloc((size_t) n * n * sizeof(double));
+    double* A_loc = checked_malloc((size_t) m_loc * n * sizeof(double));
+    if (rank == 0) {
+        A = checked_malloc((size_t) n * n * sizeof(double));
+        B = checked_malloc((size_t) n * n * sizeof(double));
+        initialize_matrices(A, B, n);
+        printf("Starting matrix multiplication: %dx%d with %d processes\n", n, n, size);
+        printf("Mode: pipeline - %d column panels of %d\n", num_panels, panel);
+        print_kernel(op);
+    }
+
+    partition_counts(part, n, counts, displs);
+    MPI_Scatterv(A, counts, displs, MPI_DOUBLE, A_loc, m_loc * n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    PipelineSlot slot[2];
+    for (int b = 0; b < 2; b++) {
+        slot[b].B_panel = checked_malloc((size_t) n * panel * sizeof(double));
+        slot[b].C_local = checked_malloc((size_t) m_loc * panel * sizeof(double));
+        slot[b].C_panel = checked_malloc((size_t) n * panel * sizeof(double));
+        slot[b].counts = checked_malloc(size * sizeof(int));
+        slot[b].displs = checked_malloc(size * sizeof(int));
+        slot[b].bcast = slot[b].gather = MPI_REQUEST_NULL;
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start_time = MPI_Wtime();
+    double compute_time = 0.0, wait_time = 0.0;
+
+    for (int p = 0; p <= num_panels; p++) {
+        // Lanza el panel p de B (el slot quedó libre al terminar el panel p - 2)
+        if (p < num_panels) {
+            PipelineSlot* s = &slot[p % 2];
+            s->j0 = p * panel;
+            s->w = n - s->j0 < panel ? n - s->j0 : panel;
+            if (rank == 0) pack_columns(B, n, s->j0, s->w, s->B_panel);
+            MPI_Ibcast(s->B_panel, n * s->w, MPI_DOUBLE, 0, MPI_COMM_WORLD, &s->bcast);
+        }
+        if (p == 0) continue;
+
+        // Multiplica el panel p - 1 mientras viajan el panel p de B y el p - 2 de C
+        PipelineSlot* s = &slot[(p - 1) % 2];
+        double t0 = MPI_Wtime();
+        MPI_Wait(&s->bcast, MPI_STATUS_IGNORE);
+        double t1 = MPI_Wtime();
+        for (int c = 0; c < PIPELINE_CHUNKS; c++) {
+            int i0 = (int) ((long) m_loc * c / PIPELINE_CHUNKS);
+            int i1 = (int) ((long) m_loc * (c + 1) / PIPELINE_CHUNKS);
+            if (i1 > i0) {
+                local_multiply(op, threads, i1 - i0, s->w, n, A_loc + (size_t) i0 * n, n,
+                               s->B_panel, s->w, s->C_local + (size_t) i0 * s->w, s->w);
+            }
+            // Da ocasión a la biblioteca de avanzar las operaciones pendientes
+            MPI_Request pending[2] = {slot[p % 2].bcast, slot[p % 2].gather};
+            int done;
+            MPI_Testall(2, pending, &done, MPI_STATUSES_IGNORE);
+            slot[p % 2].bcast = pending[0];
+            slot[p % 2].gather = pending[1];
+        }
+        double t2 = MPI_Wtime();
+
+        // El slot p % 2 se reutiliza en la siguiente vuelta: su C reunida debe llegar antes
+        PipelineSlot* prev = &slot[p % 2];
+        if (p >= 2) {
+            MPI_Wait(&prev->gather, MPI_STATUS_IGNORE);
+            unpack_columns(C, n, prev->c_j0, prev->c_w, prev->C_panel);
+        }
+        s->c_j0 = s->j0;
+        s->c_w = s->w;
+        partition_counts(part, s->w, s->counts, s->displs);
+        MPI_Iallgatherv(s->C_local, m_loc * s->w, MPI_DOUBLE, s->C_panel, s->counts, s->displs,
+                        MPI_DOUBLE, MPI_COMM_WORLD, &s->gather);
+        double t3 = MPI_Wtime();
+        compute_time += t2 - t1;
+        wait_time += (t1 - t0) + (t3 - t2);
+    }
+
+    // Último panel de C
+    PipelineSlot* last = &slot[(num_panels - 1) % 2];
+    double t0 = MPI_Wtime();
+    MPI_Wait(&last->gather, MPI_STATUS_IGNORE);
+    wait_time += MPI_Wtime() - t0;
+    unpack_columns(C, n, last->c_j0, last->c_w, last->C_panel);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double end_time = MPI_Wtime();
+
+    double times[2] = {compute_time, wait_time}, max_times[2];
+    MPI_Reduce(times, max_times, 2, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    report_rank_rates(part, n, rank, compute_time);
+
+    if (rank == 0) {
+        // Unas entradas de C (reunida en todos los rangos) contra el producto directo
+        double max_error = 0.0;
+        for (int t = 0; t < 4; t++) {
+            int i = (int) ((long) t * (n - 1) / 3), j = (int) ((long) (3 - t) * (n - 1) / 3);
+            double ref = 0.0;
+            for (int k = 0; k < n; k++) ref += A[(size_t) i * n + k] * B[(size_t) k * n + j];
+            double err = C[(size_t) i * n + j] - ref;
+            if (err < 0) err = -err;
+            if (err > max_error) max_error = err;
+        }
+        printf("Pipeline: compute %.6f s - communication wait %.6f s (max over ranks)\n",
+               max_times[0], max_times[1]);
+        printf("Verification: max error %.3e\n", max_error);
+        printf("Matrix size: %d, Processes: %d, Time: %.6f seconds\n",
+               n, size, end_time - start_time);
+    }
+
+    for (int b = 0; b < 2; b++) {
+        free(slot[b].B_panel);
+        free(slot[b].C_local);
+        free(slot[b].C_panel);
+        free(slot[b].counts);
+        free(slot[b].displs);
+    }
+    free(A);
+    free(B);
+    free(C);
+    free(A_loc);
+    free(counts);
+    free(displs);
+    return 0;
+}
+
+/*
+ * Modo shared: los rangos de un mismo nodo (MPI_Comm_split_type con
+ * MPI_COMM_TYPE_SHARED) comparten una sola copia de B y de C en ventanas
+ * MPI_Win_allocate_shared. Sólo los líderes de nodo participan en la difusión
+ * de B y en el intercambio de C entre nodos; cada rango escribe sus filas de C
+ * directamente en la ventana del nodo.
+ */
+
+// Reserva n x n doubles en el líder del nodo y devuelve el puntero compartido
+static double* allocate_node_matrix(int n, MPI_Comm node_comm, int node_rank, MPI_Win* win) {
+    double* base;
+    MPI_Aint bytes = node_rank == 0 ? (MPI_Aint) n * n * sizeof(double) : 0;
+    MPI_Win_allocate_shared(bytes, sizeof(double), MPI_INFO_NULL, node_comm, &base, win);
+
+    MPI_Aint leader_bytes;
+    int disp_unit;
+    MPI_Win_shared_query(*win, 0, &leader_bytes, &disp_unit, &base);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, *win);
+    return base;
+}
+
+// Hace visibles a todo el nodo las escrituras en la ventana
+static void node_sync(MPI_Win win, MPI_Comm node_comm) {
+    MPI_Win_sync(win);
+    MPI_Barrier(node_comm);
+    MPI_Win_sync(win);
+}
+
+int run_shared(int n, int rank, int size, const OpcionesGemm* op, int threads) {
+    MPI_Comm node_comm, leaders_comm;
+    int node_rank, node_size;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+    MPI_Comm_rank(node_comm, &node_rank);
+    MPI_Comm_size(node_comm, &node_size);
+    MPI_Comm_split(MPI_COMM_WORLD, node_rank == 0 ? 0 : MPI_UNDEFINED, rank, &leaders_comm);
+
+    // Los nodos ocupan franjas contiguas de filas: el rango local r del nodo
+    // con `before` rangos previos toma el bloque before + r de `size`
+    int num_nodes = 0, before = 0;
+    int* node_sizes = NULL;
+    if (node_rank == 0) {
+        int leader_rank;
+        MPI_Comm_size(leaders_comm, &num_nodes);
+        MPI_Comm_rank(leaders_comm, &leader_rank);
+        node_sizes = checked_malloc(num_nodes * sizeof(int));
+        MPI_Allgather(&node_size, 1, MPI_INT, node_sizes, 1, MPI_INT, leaders_comm);
+        for (int i = 0; i < leader_rank; i++) before += node_sizes[i];
+    }
+    MPI_Bcast(&before, 1, MPI_INT, 0, node_comm);
+    MPI_Bcast(&num_nodes, 1, MPI_INT, 0, node_comm);
+    int slot = before + node_rank;
+    RowPartition part;
+    partition_uniform(&part, n, size);
+    int r0 = part.start[slot], m_loc = PARTITION_ROWS(&part, slot);
+
+    MPI_Win win_B, win_C;
+    double* B = allocate_node_matrix(n, node_comm, node_rank, &win_B);
+    double* C = allocate_node_matrix(n, node_comm, node_rank, &win_C);
+
+    // A: sólo las filas propias, repartidas desde el rango 0 según su bloque
+    double* A = NULL;
+    double* A_loc = checked_malloc((size_t) m_loc * n * sizeof(double));
+    int* slots = checked_malloc(size * sizeof(int));
+    int* counts = checked_malloc(size * sizeof(int));
+    int* displs = checked_malloc(size * sizeof(int));
+    MPI_Gather(&slot, 1, MPI_INT, slots, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        for (int r = 0; r < size; r++) {
+            displs[r] = part.start[slots[r]] * n;
+            counts[r] = PARTITION_ROWS(&part, slots[r]) * n;
+        }
+        A = checked_malloc((size_t) n * n * sizeof(double));
+        initialize_matrices(A, B, n);   // B va directo a la ventana del nodo 0
+        printf("Starting matrix multiplication: %dx%d with %d processes\n", n, n, size);
+        printf("Mode: shared - %d nodes - one copy of B and C per node\n", num_nodes);
+        print_kernel(op);
+    }
+
+    double dist_start = MPI_Wtime();
+    MPI_Scatterv(A, counts, displs, MPI_DOUBLE, A_loc, m_loc * n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (node_rank == 0) {
+        MPI_Bcast(B, n * n, MPI_DOUBLE, 0, leaders_comm);
+    }
+    node_sync(win_B, node_comm);
+    double dist_time = MPI_Wtime() - dist_start;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start_time = MPI_Wtime();
+
+    local_multiply(op, threads, m_loc, n, n, A_loc, n, B, n, C + (size_t) r0 * n, n);
+    node_sync(win_C, node_comm);
+
+    // Cada líder aporta la franja de su nodo, ya completa en la ventana
+    if (node_rank == 0) {
+        for (int i = 0, acc = 0; i < num_nodes; i++) {
+            displs[i] = part.start[acc] * n;
+            acc += node_sizes[i];
+            counts[i] = part.start[acc] * n - displs[i];
+        }
+        MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, C, counts, displs, MPI_DOUBLE,
+                       leaders_comm);
+    }
+    node_sync(win_C, node_comm);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double end_time = MPI_Wtime();
+
+    if (rank == 0) {
+        double max_error = 0.0;
+        for (int t = 0; t < 4; t++) {
+            int i = (int) ((long) t * (n - 1) / 3), j = (int) ((long) (3 - t) * (n - 1) / 3);
+            double ref = 0.0;
+            for (int k = 0; k < n; k++) ref += A[(size_t) i * n + k] * B[(size_t) k * n + j];
+            double err = C[(size_t) i * n + j] - ref;
+            if (err < 0) err = -err;
+            if (err > max_error) max_error = err;
+        }
+        printf("Distribution (A rows + B to node leaders): %.6f seconds\n", dist_time);
+        printf("Verification: max error %.3e\n", max_error);
+        printf("Matrix size: %d, Processes: %d, Time: %.6f seconds\n",
+               n, size, end_time - start_time);
+    }
+
+    MPI_Win_unlock_all(win_B);
+    MPI_Win_unlock_all(win_C);
+    MPI_Win_free(&win_B);
+    MPI_Win_free(&win_C);
+    if (leaders_comm != MPI_COMM_NULL) MPI_Comm_free(&leaders_comm);
+    MPI_Comm_free(&node_comm);
+    free(node_sizes);
+    free(A);
+    free(A_loc);
+    free(slots);
+    partition_free(&part);
+    free(counts);
+    free(displs);
+    return 0;
 }
 
 void print_matrix(double* matrix, int n, const char* name) {
@@ -41,15 +741,63 @@ void print_matrix(double* matrix, int n, const char* name) {
 }
 
 int main(int argc, char** argv) {
-    MPI_Init(&argc, &argv);
+    // Modo híbrido: los hilos OpenMP calculan y sólo el principal comunica
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
     
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
     
-    if (argc != 2) {
+    // El motor empaquetado es el núcleo de cálculo por defecto
+    OpcionesGemm op;
+    opciones_gemm_defecto(&op, sizeof(double));
+    op.kernel = KERNEL_EMPAQUETADO;
+    // --mode=rows (filas replicadas, por defecto) | summa (malla 2D) | pipeline | shared
+    RunMode mode = MODE_ROWS;
+    IoOptions io = {NULL, NULL, NULL, NULL};
+    const char* weights_arg = NULL;     // --weights=FILE|calibrate (NULL: reparto uniforme)
+    int panel = SUMMA_PANEL_DEFAULT, threads = 1, valid = argc >= 2;
+    for (int i = 2; valid && i < argc; i++) {
+        int r = parsear_opcion_gemm(argv[i], &op);
+        if (r == 0 && strcmp(argv[i], "--mode=rows") == 0) {
+            mode = MODE_ROWS;
+        } else if (r == 0 && strcmp(argv[i], "--mode=summa") == 0) {
+            mode = MODE_SUMMA;
+        } else if (r == 0 && strcmp(argv[i], "--mode=pipeline") == 0) {
+            mode = MODE_PIPELINE;
+        } else if (r == 0 && strcmp(argv[i], "--mode=shared") == 0) {
+            mode = MODE_SHARED;
+        } else if (r == 0 && strncmp(argv[i], "--panel=", 8) == 0) {
+            panel = atoi(argv[i] + 8);
+            valid = panel > 0;
+        } else if (r == 0 && strncmp(argv[i], "--input-a=", 10) == 0) {
+            io.input_a = argv[i] + 10;
+        } else if (r == 0 && strncmp(argv[i], "--input-b=", 10) == 0) {
+            io.input_b = argv[i] + 10;
+        } else if (r == 0 && strncmp(argv[i], "--output-c=", 11) == 0) {
+            io.output_c = argv[i] + 11;
+        } else if (r == 0 && strncmp(argv[i], "--save-inputs=", 14) == 0) {
+            io.save_prefix = argv[i] + 14;
+        } else if (r == 0 && strncmp(argv[i], "--weights=", 10) == 0) {
+            weights_arg = argv[i] + 10;
+            valid = weights_arg[0] != '\0';
+        } else if (r == 0 && strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = atoi(argv[i] + 10);
+            valid = threads > 0;
+        } else if (r == 0) {
+            if (rank == 0) fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            valid = 0;
+        } else if (r < 0) {
+            valid = 0;
+        }
+    }
+    if (!valid) {
         if (rank == 0) {
-            printf("Usage: mpirun -np <processes> %s <matrix_size>\n", argv[0]);
+            printf("Usage: mpirun -np <processes> %s <matrix_size> " OPCIONES_GEMM_USO
+                   " [--mode=rows|summa|pipeline|shared] [--panel=N] [--threads=N]"
+                   " [--input-a=FILE] [--input-b=FILE] [--output-c=FILE] [--save-inputs=PREFIX]"
+                   " [--weights=FILE|calibrate]\n", argv[0]);
         }
         MPI_Finalize();
         return 1;
@@ -65,6 +813,55 @@ int main(int argc, char** argv) {
         return 1;
     }
     
+    if (threads > 1 && provided < MPI_THREAD_FUNNELED) {
+        if (rank == 0) {
+            printf("Warning: MPI only provides thread level %d; running with 1 thread per rank\n",
+                   provided);
+        }
+        threads = 1;
+    }
+    if (rank == 0 && threads > 1) {
+        printf("Hybrid: %d ranks x %d threads per rank\n", size, threads);
+    }
+
+    int use_io = io.input_a || io.input_b || io.output_c || io.save_prefix;
+    if (use_io && (mode == MODE_PIPELINE || mode == MODE_SHARED)) {
+        if (rank == 0) {
+            printf("Error: matrix files are only supported with --mode=rows and --mode=summa\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (weights_arg && (mode == MODE_SUMMA || mode == MODE_SHARED)) {
+        if (rank == 0) {
+            printf("Error: --weights is only supported with --mode=rows and --mode=pipeline\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Un único reparto de filas para el cálculo, la distribución y la recolección
+    RowPartition part;
+    if ((mode == MODE_ROWS || mode == MODE_PIPELINE) &&
+        build_partition(&part, n, rank, size, weights_arg, &op, threads) != 0) {
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (mode != MODE_ROWS) {
+        int status;
+        if (mode == MODE_SUMMA)
+            status = run_summa(n, rank, size, panel, &op, threads, &io);
+        else if (mode == MODE_PIPELINE)
+            status = run_pipeline(n, rank, size, panel, &part, &op, threads);
+        else
+            status = run_shared(n, rank, size, &op, threads);
+        if (mode == MODE_PIPELINE) partition_free(&part);
+        MPI_Finalize();
+        return status;
+    }
+
     // Verificar que el tamaño de matriz sea divisible por el número de procesos
     if (n % size != 0) {
         if (rank == 0) {
@@ -83,35 +880,42 @@ int main(int argc, char** argv) {
     }
     
     // Inicialización de matrices (solo proceso 0)
+    int start_row = part.start[rank], end_row = part.start[rank + 1];
     if (rank == 0) {
-        initialize_matrices(A, B, n);
+        if (!io.input_a || !io.input_b) initialize_matrices(A, B, n);
         printf("Starting matrix multiplication: %dx%d with %d processes\n", n, n, size);
+        print_kernel(&op);
     }
     
-    // Broadcast de matrices
-    MPI_Bcast(A, n*n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-    MPI_Bcast(B, n*n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    // Broadcast de matrices. Desde archivo, cada rango lee sus filas de A y B completa.
+    if (io.input_a) {
+        load_block(io.input_a, n, start_row, end_row, 0, n, A + (size_t) start_row * n);
+    } else {
+        MPI_Bcast(A, n*n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    }
+    if (io.input_b) {
+        load_block(io.input_b, n, 0, n, 0, n, B);
+    } else {
+        MPI_Bcast(B, n*n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    }
+    if (io.save_prefix) {
+        save_inputs(io.save_prefix, n, start_row, end_row, 0, n,
+                    A + (size_t) start_row * n, B + (size_t) start_row * n);
+    }
     
     // Sincronización antes de medir tiempo
     MPI_Barrier(MPI_COMM_WORLD);
     double start_time = MPI_Wtime();
     
     // Realizar multiplicación de matrices
-    matrix_multiply_mpi(A, B, C, n, rank, size);
+    double compute_start = MPI_Wtime();
+    matrix_multiply_mpi(A, B, C, n, &part, rank, &op, threads);
+    double compute_time = MPI_Wtime() - compute_start;
     
-    // Recolección de resultados
-    int rows_per_process = n / size;
-    int remainder = n % size;
-    
-    // Calcular las cuentas y desplazamientos para cada proceso
+    // Recolección de resultados con las mismas franjas que el cálculo
     int* sendcounts = malloc(size * sizeof(int));
     int* displs = malloc(size * sizeof(int));
-    
-    for (int i = 0; i < size; i++) {
-        int rows = rows_per_process + (i < remainder ? 1 : 0);
-        sendcounts[i] = rows * n;
-        displs[i] = (i == 0) ? 0 : displs[i-1] + sendcounts[i-1];
-    }
+    partition_counts(&part, n, sendcounts, displs);
     
     // Usar Allgatherv para manejar distribución no uniforme
     MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
@@ -119,6 +923,18 @@ int main(int argc, char** argv) {
     
     MPI_Barrier(MPI_COMM_WORLD);
     double end_time = MPI_Wtime();
+
+    // Desde archivo cada rango sólo leyó sus filas de A: se reúnen para imprimirla
+    if (io.input_a && n <= 10) {
+        MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                       A, sendcounts, displs, MPI_DOUBLE, MPI_COMM_WORLD);
+    }
+
+    // Cada rango escribe las filas de C que calculó
+    if (io.output_c) {
+        store_block(io.output_c, n, start_row, end_row, 0, n, C + (size_t) start_row * n);
+    }
+    report_rank_rates(&part, n, rank, compute_time);
     
     if (rank == 0) {
         double execution_time = end_time - start_time;
@@ -138,6 +954,7 @@ int main(int argc, char** argv) {
     free(C);
     free(sendcounts);
     free(displs);
+    partition_free(&part);
     
     MPI_Finalize();
     return 0;
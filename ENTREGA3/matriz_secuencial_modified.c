@@ -1,7 +1,11 @@
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include "../comun/gemm.h"
+
 void matrix_multiply_sequential(double* A, double* B, double* C, int n) {
     for (int i = 0; i < n; i++) {
         for (int j = 0; j < n; j++) {
@@ -33,8 +37,30 @@ void print_matrix(double* matrix, int n, const char* name) {
 }
 
 int main(int argc, char** argv) {
-    if (argc != 2) {
-        printf("Usage: %s <matrix_size>\n", argv[0]);
+    // El motor empaquetado es el núcleo de cálculo por defecto
+    OpcionesGemm op;
+    opciones_gemm_defecto(&op, sizeof(double));
+    op.kernel = KERNEL_EMPAQUETADO;
+    // --strassen: Strassen-Winograd con corte calibrado (o --corte=N)
+    int strassen = 0, corte = 0, valid = argc >= 2;
+    for (int i = 2; valid && i < argc; i++) {
+        int r = parsear_opcion_gemm(argv[i], &op);
+        if (r == 0 && strcmp(argv[i], "--strassen") == 0) {
+            strassen = 1;
+        } else if (r == 0 && strcmp(argv[i], "--corte=auto") == 0) {
+            corte = 0;
+        } else if (r == 0 && strncmp(argv[i], "--corte=", 8) == 0) {
+            corte = atoi(argv[i] + 8);
+            valid = corte > 0;
+        } else if (r == 0) {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            valid = 0;
+        } else if (r < 0) {
+            valid = 0;
+        }
+    }
+    if (!valid) {
+        printf("Usage: %s <matrix_size> " OPCIONES_GEMM_USO " [--strassen] [--corte=N|auto]\n", argv[0]);
         return 1;
     }
     
@@ -59,13 +85,59 @@ int main(int argc, char** argv) {
     initialize_matrix(B, n, 2);
     
     printf("Starting sequential matrix multiplication: %dx%d\n", n, n);
+    if (op.kernel == KERNEL_EMPAQUETADO) {
+        printf("Kernel: %s (%s)\n", nombre_kernel(op.kernel), descripcion_empaquetado_double());
+    } else {
+        printf("Kernel: %s\n", nombre_kernel(op.kernel));
+    }
     
+    // Strassen: el plan (corte y arena) se prepara fuera de la medición
+    PlanStrassen plan;
+    if (strassen) {
+        if (corte == 0) corte = calibrar_corte_strassen_double(n, 1, &op);
+        plan = crear_plan_strassen(n, corte, 1, sizeof(double), &op);
+        printf("Strassen: cutoff %d - padded size %d\n", plan.corte, plan.N);
+    }
+
     clock_t start = clock();
-    matrix_multiply_sequential(A, B, C, n);
+    if (strassen) {
+        multiplicar_strassen_double(&plan, A, n, B, n, C, n, &op);
+    } else if (op.kernel != KERNEL_INGENUO) {
+        multiplicar_double(&op, n, n, n, A, n, B, n, C, n);
+    } else {
+        matrix_multiply_sequential(A, B, C, n);
+    }
     clock_t end = clock();
     
     double time_spent = (double)(end - start) / CLOCKS_PER_SEC;
     printf("Sequential Time: %.6f seconds\n", time_spent);
+
+    // Precisión de Strassen frente al producto clásico del kernel elegido
+    if (strassen) {
+        double* R = malloc((size_t) n * n * sizeof(double));
+        if (!R) {
+            printf("Error: Memory allocation failed\n");
+            return 1;
+        }
+        start = clock();
+        if (op.kernel != KERNEL_INGENUO) {
+            multiplicar_double(&op, n, n, n, A, n, B, n, R, n);
+        } else {
+            matrix_multiply_sequential(A, B, R, n);
+        }
+        end = clock();
+
+        double max_error = 0.0, max_ref = 0.0;
+        for (size_t i = 0; i < (size_t) n * n; i++) {
+            max_error = fmax(max_error, fabs(C[i] - R[i]));
+            max_ref = fmax(max_ref, fabs(R[i]));
+        }
+        printf("Classical Time: %.6f seconds\n", (double)(end - start) / CLOCKS_PER_SEC);
+        printf("Strassen max abs error: %.3e - max relative error: %.3e\n",
+               max_error, max_ref > 0.0 ? max_error / max_ref : 0.0);
+        free(R);
+        liberar_plan_strassen(&plan);
+    }
     
     // Imprimir resultado solo para matrices pequeñas
     if (n <= 10) {
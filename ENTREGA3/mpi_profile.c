@@ -0,0 +1,496 @@
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi_profile.h"
+
+/*
+ * Capa de perfilado por interposición PMPI. Se enlaza con matrix_mpi (o se
+ * precarga como biblioteca compartida) y mide, por rango:
+ *
+ *   - llamadas, tiempo y bytes de cada colectiva, de las esperas de las
+ *     operaciones no bloqueantes (Wait / Waitall / Testall), de la E/S
+ *     colectiva (MPI_File_*), de la creación de comunicadores y de las
+ *     ventanas de memoria compartida;
+ *   - tiempo de cómputo: el de los tramos que matrix_mpi marca con
+ *     MPI_Pcontrol (mpi_profile.h), medido directamente;
+ *   - otro tiempo = pared entre MPI_Init y MPI_Finalize menos MPI y
+ *     cómputo (generación de datos, empaquetado, verificación);
+ *   - espera en barreras (tiempo en MPI_Barrier).
+ *
+ * Los bytes son los de la carga útil que entra o sale del rango según los
+ * argumentos de la llamada (no los que mueve internamente el algoritmo).
+ *
+ * En MPI_Finalize el rango 0 reúne los contadores y escribe <prefijo>.csv
+ * (una fila por rango y operación) y <prefijo>.json (resumen por rango y
+ * métricas de desbalance). El prefijo se toma de HPC_PROFILE (por defecto
+ * "mpi_profile"). Sólo el hilo maestro llama a MPI (MPI_THREAD_FUNNELED),
+ * así que los contadores no necesitan protección.
+ */
+
+typedef enum {
+    OP_BCAST, OP_IBCAST, OP_SCATTERV, OP_GATHER, OP_ALLGATHER, OP_ALLGATHERV,
+    OP_IALLGATHERV, OP_REDUCE, OP_ALLREDUCE, OP_BARRIER, OP_WAIT, OP_WAITALL,
+    OP_TESTALL, OP_FILE_OPEN, OP_FILE_CLOSE, OP_FILE_SET_VIEW, OP_FILE_SET_SIZE,
+    OP_FILE_READ_AT_ALL, OP_FILE_WRITE_AT_ALL, OP_COMM_SPLIT, OP_COMM_SPLIT_TYPE,
+    OP_CART_CREATE, OP_CART_SUB, OP_WIN_ALLOCATE_SHARED, OP_WIN_LOCK_ALL,
+    OP_WIN_UNLOCK_ALL, OP_WIN_SYNC, OP_WIN_FREE, OP_COUNT
+} ProfileOp;
+
+static const char* op_names[OP_COUNT] = {
+    "MPI_Bcast", "MPI_Ibcast", "MPI_Scatterv", "MPI_Gather", "MPI_Allgather", "MPI_Allgatherv",
+    "MPI_Iallgatherv", "MPI_Reduce", "MPI_Allreduce", "MPI_Barrier", "MPI_Wait", "MPI_Waitall",
+    "MPI_Testall", "MPI_File_open", "MPI_File_close", "MPI_File_set_view", "MPI_File_set_size",
+    "MPI_File_read_at_all", "MPI_File_write_at_all", "MPI_Comm_split", "MPI_Comm_split_type",
+    "MPI_Cart_create", "MPI_Cart_sub", "MPI_Win_allocate_shared", "MPI_Win_lock_all",
+    "MPI_Win_unlock_all", "MPI_Win_sync", "MPI_Win_free"
+};
+
+// Contadores de un rango: por operación llamadas, segundos y bytes; después
+// los tramos de cómputo (llamadas y segundos) y la pared total
+#define STATS_PER_OP 3
+#define STAT_COMPUTE_CALLS (OP_COUNT * STATS_PER_OP)
+#define STAT_COMPUTE_S (STAT_COMPUTE_CALLS + 1)
+#define STAT_WALL (STAT_COMPUTE_CALLS + 2)
+#define STATS_LEN (STAT_WALL + 1)
+
+static double stats[STATS_LEN];
+static double init_time;
+static double compute_start;
+static int compute_depth;     // Tramos de cómputo abiertos (se anidan)
+
+static void record(ProfileOp op, double t0, double bytes) {
+    stats[op * STATS_PER_OP] += 1.0;
+    stats[op * STATS_PER_OP + 1] += PMPI_Wtime() - t0;
+    stats[op * STATS_PER_OP + 2] += bytes;
+}
+
+static double type_bytes(MPI_Datatype type, int count) {
+    int size;
+    PMPI_Type_size(type, &size);
+    return (double) size * count;
+}
+
+static void comm_info(MPI_Comm comm, int* rank, int* size) {
+    PMPI_Comm_rank(comm, rank);
+    PMPI_Comm_size(comm, size);
+}
+
+// Bytes que recibe un rango en un allgatherv: todos los bloques menos el propio
+static double allgatherv_bytes(const void* sendbuf, int sendcount, MPI_Datatype sendtype,
+                               const int recvcounts[], MPI_Datatype recvtype, MPI_Comm comm) {
+    int rank, size;
+    comm_info(comm, &rank, &size);
+    long others = 0;
+    for (int r = 0; r < size; r++) {
+        if (r != rank) others += recvcounts[r];
+    }
+    double sent = sendbuf == MPI_IN_PLACE ? type_bytes(recvtype, recvcounts[rank])
+                                          : type_bytes(sendtype, sendcount);
+    return sent + type_bytes(recvtype, (int) others);
+}
+
+// Bytes de una lectura o escritura de archivo del rango
+static double file_bytes(MPI_Datatype type, int count) {
+    return count > 0 ? type_bytes(type, count) : 0.0;
+}
+
+int MPI_Init(int* argc, char*** argv) {
+    int status = PMPI_Init(argc, argv);
+    init_time = PMPI_Wtime();
+    return status;
+}
+
+int MPI_Init_thread(int* argc, char*** argv, int required, int* provided) {
+    int status = PMPI_Init_thread(argc, argv, required, provided);
+    init_time = PMPI_Wtime();
+    return status;
+}
+
+int MPI_Bcast(void* buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Bcast(buffer, count, datatype, root, comm);
+    record(OP_BCAST, t0, type_bytes(datatype, count));
+    return status;
+}
+
+int MPI_Ibcast(void* buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm,
+               MPI_Request* request) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Ibcast(buffer, count, datatype, root, comm, request);
+    record(OP_IBCAST, t0, type_bytes(datatype, count));
+    return status;
+}
+
+int MPI_Scatterv(const void* sendbuf, const int sendcounts[], const int displs[],
+                 MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype,
+                 int root, MPI_Comm comm) {
+    int rank, size;
+    comm_info(comm, &rank, &size);
+    double bytes = 0.0;
+    if (rank == root) {
+        long others = 0;
+        for (int r = 0; r < size; r++) {
+            if (r != root) others += sendcounts[r];
+        }
+        bytes = type_bytes(sendtype, (int) others);
+    } else {
+        bytes = type_bytes(recvtype, recvcount);
+    }
+
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Scatterv(sendbuf, sendcounts, displs, sendtype, recvbuf, recvcount,
+                               recvtype, root, comm);
+    record(OP_SCATTERV, t0, bytes);
+    return status;
+}
+
+int MPI_Gather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf,
+               int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm) {
+    int rank, size;
+    comm_info(comm, &rank, &size);
+    double bytes = rank == root ? type_bytes(recvtype, recvcount) * (size - 1)
+                                : type_bytes(sendtype, sendcount);
+
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Gather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
+    record(OP_GATHER, t0, bytes);
+    return status;
+}
+
+int MPI_Allgather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf,
+                  int recvcount, MPI_Datatype recvtype, MPI_Comm comm) {
+    int rank, size;
+    comm_info(comm, &rank, &size);
+    double bytes = type_bytes(recvtype, recvcount) * size;
+
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Allgather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm);
+    record(OP_ALLGATHER, t0, bytes);
+    return status;
+}
+
+int MPI_Allgatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf,
+                   const int recvcounts[], const int displs[], MPI_Datatype recvtype,
+                   MPI_Comm comm) {
+    double bytes = allgatherv_bytes(sendbuf, sendcount, sendtype, recvcounts, recvtype, comm);
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Allgatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs,
+                                 recvtype, comm);
+    record(OP_ALLGATHERV, t0, bytes);
+    return status;
+}
+
+int MPI_Iallgatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf,
+                    const int recvcounts[], const int displs[], MPI_Datatype recvtype,
+                    MPI_Comm comm, MPI_Request* request) {
+    double bytes = allgatherv_bytes(sendbuf, sendcount, sendtype, recvcounts, recvtype, comm);
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Iallgatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs,
+                                  recvtype, comm, request);
+    record(OP_IALLGATHERV, t0, bytes);
+    return status;
+}
+
+int MPI_Reduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op,
+               int root, MPI_Comm comm) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
+    record(OP_REDUCE, t0, type_bytes(datatype, count));
+    return status;
+}
+
+int MPI_Allreduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype,
+                  MPI_Op op, MPI_Comm comm) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+    record(OP_ALLREDUCE, t0, 2.0 * type_bytes(datatype, count));
+    return status;
+}
+
+int MPI_Barrier(MPI_Comm comm) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Barrier(comm);
+    record(OP_BARRIER, t0, 0.0);
+    return status;
+}
+
+int MPI_Wait(MPI_Request* request, MPI_Status* status) {
+    double t0 = PMPI_Wtime();
+    int result = PMPI_Wait(request, status);
+    record(OP_WAIT, t0, 0.0);
+    return result;
+}
+
+int MPI_Waitall(int count, MPI_Request requests[], MPI_Status statuses[]) {
+    double t0 = PMPI_Wtime();
+    int result = PMPI_Waitall(count, requests, statuses);
+    record(OP_WAITALL, t0, 0.0);
+    return result;
+}
+
+int MPI_Testall(int count, MPI_Request requests[], int* flag, MPI_Status statuses[]) {
+    double t0 = PMPI_Wtime();
+    int result = PMPI_Testall(count, requests, flag, statuses);
+    record(OP_TESTALL, t0, 0.0);
+    return result;
+}
+
+int MPI_File_open(MPI_Comm comm, const char* filename, int amode, MPI_Info info, MPI_File* fh) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_File_open(comm, filename, amode, info, fh);
+    record(OP_FILE_OPEN, t0, 0.0);
+    return status;
+}
+
+int MPI_File_close(MPI_File* fh) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_File_close(fh);
+    record(OP_FILE_CLOSE, t0, 0.0);
+    return status;
+}
+
+int MPI_File_set_view(MPI_File fh, MPI_Offset disp, MPI_Datatype etype, MPI_Datatype filetype,
+                      const char* datarep, MPI_Info info) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_File_set_view(fh, disp, etype, filetype, datarep, info);
+    record(OP_FILE_SET_VIEW, t0, 0.0);
+    return status;
+}
+
+int MPI_File_set_size(MPI_File fh, MPI_Offset size) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_File_set_size(fh, size);
+    record(OP_FILE_SET_SIZE, t0, 0.0);
+    return status;
+}
+
+int MPI_File_read_at_all(MPI_File fh, MPI_Offset offset, void* buf, int count,
+                         MPI_Datatype datatype, MPI_Status* status) {
+    double t0 = PMPI_Wtime();
+    int result = PMPI_File_read_at_all(fh, offset, buf, count, datatype, status);
+    record(OP_FILE_READ_AT_ALL, t0, file_bytes(datatype, count));
+    return result;
+}
+
+int MPI_File_write_at_all(MPI_File fh, MPI_Offset offset, const void* buf, int count,
+                          MPI_Datatype datatype, MPI_Status* status) {
+    double t0 = PMPI_Wtime();
+    int result = PMPI_File_write_at_all(fh, offset, buf, count, datatype, status);
+    record(OP_FILE_WRITE_AT_ALL, t0, file_bytes(datatype, count));
+    return result;
+}
+
+int MPI_Comm_split(MPI_Comm comm, int color, int key, MPI_Comm* newcomm) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Comm_split(comm, color, key, newcomm);
+    record(OP_COMM_SPLIT, t0, 0.0);
+    return status;
+}
+
+int MPI_Comm_split_type(MPI_Comm comm, int split_type, int key, MPI_Info info,
+                        MPI_Comm* newcomm) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Comm_split_type(comm, split_type, key, info, newcomm);
+    record(OP_COMM_SPLIT_TYPE, t0, 0.0);
+    return status;
+}
+
+int MPI_Cart_create(MPI_Comm old_comm, int ndims, const int dims[], const int periods[],
+                    int reorder, MPI_Comm* comm_cart) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Cart_create(old_comm, ndims, dims, periods, reorder, comm_cart);
+    record(OP_CART_CREATE, t0, 0.0);
+    return status;
+}
+
+int MPI_Cart_sub(MPI_Comm comm, const int remain_dims[], MPI_Comm* new_comm) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Cart_sub(comm, remain_dims, new_comm);
+    record(OP_CART_SUB, t0, 0.0);
+    return status;
+}
+
+int MPI_Win_allocate_shared(MPI_Aint size, int disp_unit, MPI_Info info, MPI_Comm comm,
+                            void* baseptr, MPI_Win* win) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Win_allocate_shared(size, disp_unit, info, comm, baseptr, win);
+    record(OP_WIN_ALLOCATE_SHARED, t0, 0.0);
+    return status;
+}
+
+int MPI_Win_lock_all(int assert, MPI_Win win) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Win_lock_all(assert, win);
+    record(OP_WIN_LOCK_ALL, t0, 0.0);
+    return status;
+}
+
+int MPI_Win_unlock_all(MPI_Win win) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Win_unlock_all(win);
+    record(OP_WIN_UNLOCK_ALL, t0, 0.0);
+    return status;
+}
+
+int MPI_Win_sync(MPI_Win win) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Win_sync(win);
+    record(OP_WIN_SYNC, t0, 0.0);
+    return status;
+}
+
+int MPI_Win_free(MPI_Win* win) {
+    double t0 = PMPI_Wtime();
+    int status = PMPI_Win_free(win);
+    record(OP_WIN_FREE, t0, 0.0);
+    return status;
+}
+
+// Tramos de cómputo marcados por la aplicación; el resto de niveles se reenvía
+int MPI_Pcontrol(const int level, ...) {
+    if (level == PROFILE_COMPUTE_BEGIN) {
+        if (compute_depth++ == 0) compute_start = PMPI_Wtime();
+        return MPI_SUCCESS;
+    }
+    if (level == PROFILE_COMPUTE_END) {
+        if (compute_depth > 0 && --compute_depth == 0) {
+            stats[STAT_COMPUTE_CALLS] += 1.0;
+            stats[STAT_COMPUTE_S] += PMPI_Wtime() - compute_start;
+        }
+        return MPI_SUCCESS;
+    }
+    return PMPI_Pcontrol(level);
+}
+
+// Tiempo de un rango dentro de las llamadas medidas
+static double mpi_seconds(const double* s) {
+    double total = 0.0;
+    for (int op = 0; op < OP_COUNT; op++) total += s[op * STATS_PER_OP + 1];
+    return total;
+}
+
+static double rank_bytes(const double* s) {
+    double total = 0.0;
+    for (int op = 0; op < OP_COUNT; op++) total += s[op * STATS_PER_OP + 2];
+    return total;
+}
+
+// Función para escribir el CSV y el JSON con los contadores de todos los rangos
+static void write_report(const char* prefix, const double* all, const char* hosts, int size) {
+    char path[1024];
+    double compute_max = 0.0, compute_min = 0.0, compute_sum = 0.0;
+    double wall_sum = 0.0, mpi_sum = 0.0, barrier_max = 0.0, barrier_min = 0.0;
+
+    for (int r = 0; r < size; r++) {
+        const double* s = all + (size_t) r * STATS_LEN;
+        double wall = s[STAT_WALL], mpi = mpi_seconds(s);
+        double compute = s[STAT_COMPUTE_S], barrier = s[OP_BARRIER * STATS_PER_OP + 1];
+        if (r == 0 || compute > compute_max) compute_max = compute;
+        if (r == 0 || compute < compute_min) compute_min = compute;
+        if (r == 0 || barrier > barrier_max) barrier_max = barrier;
+        if (r == 0 || barrier < barrier_min) barrier_min = barrier;
+        compute_sum += compute;
+        wall_sum += wall;
+        mpi_sum += mpi;
+    }
+    double compute_avg = compute_sum / size;
+    // Desbalance: max/media - 1 (0 = perfecto) y tiempo perdido (max-media)/max
+    double imbalance = compute_avg > 0.0 ? compute_max / compute_avg - 1.0 : 0.0;
+    double lost = compute_max > 0.0 ? (compute_max - compute_avg) / compute_max : 0.0;
+    double mpi_fraction = wall_sum > 0.0 ? mpi_sum / wall_sum : 0.0;
+
+    snprintf(path, sizeof(path), "%s.csv", prefix);
+    FILE* csv = fopen(path, "w");
+    if (!csv) {
+        perror("Error al crear el perfil CSV");
+        return;
+    }
+    fprintf(csv, "Rank,Host,Operation,Calls,Time_s,Bytes\n");
+    for (int r = 0; r < size; r++) {
+        const double* s = all + (size_t) r * STATS_LEN;
+        const char* host = hosts + (size_t) r * MPI_MAX_PROCESSOR_NAME;
+        for (int op = 0; op < OP_COUNT; op++) {
+            const double* o = s + op * STATS_PER_OP;
+            if (o[0] == 0.0) continue;
+            fprintf(csv, "%d,%s,%s,%.0f,%.6f,%.0f\n", r, host, op_names[op], o[0], o[1], o[2]);
+        }
+        fprintf(csv, "%d,%s,compute,%.0f,%.6f,0\n", r, host, s[STAT_COMPUTE_CALLS], s[STAT_COMPUTE_S]);
+        fprintf(csv, "%d,%s,other,0,%.6f,0\n", r, host,
+                s[STAT_WALL] - mpi_seconds(s) - s[STAT_COMPUTE_S]);
+        fprintf(csv, "%d,%s,total,0,%.6f,%.0f\n", r, host, s[STAT_WALL], rank_bytes(s));
+    }
+    fclose(csv);
+
+    snprintf(path, sizeof(path), "%s.json", prefix);
+    FILE* json = fopen(path, "w");
+    if (!json) {
+        perror("Error al crear el perfil JSON");
+        return;
+    }
+    fprintf(json, "{\n  \"ranks\": %d,\n  \"per_rank\": [\n", size);
+    for (int r = 0; r < size; r++) {
+        const double* s = all + (size_t) r * STATS_LEN;
+        double wall = s[STAT_WALL], mpi = mpi_seconds(s), compute = s[STAT_COMPUTE_S];
+        fprintf(json, "    {\"rank\": %d, \"host\": \"%s\", \"wall_s\": %.6f, \"compute_s\": %.6f, "
+                "\"mpi_s\": %.6f, \"other_s\": %.6f, \"barrier_wait_s\": %.6f, \"bytes\": %.0f, "
+                "\"ops\": {",
+                r, hosts + (size_t) r * MPI_MAX_PROCESSOR_NAME, wall, compute, mpi,
+                wall - mpi - compute, s[OP_BARRIER * STATS_PER_OP + 1], rank_bytes(s));
+        int first = 1;
+        for (int op = 0; op < OP_COUNT; op++) {
+            const double* o = s + op * STATS_PER_OP;
+            if (o[0] == 0.0) continue;
+            fprintf(json, "%s\"%s\": {\"calls\": %.0f, \"time_s\": %.6f, \"bytes\": %.0f}",
+                    first ? "" : ", ", op_names[op], o[0], o[1], o[2]);
+            first = 0;
+        }
+        fprintf(json, "}}%s\n", r == size - 1 ? "" : ",");
+    }
+    fprintf(json, "  ],\n  \"imbalance\": {\"compute_max_s\": %.6f, \"compute_avg_s\": %.6f, "
+            "\"compute_min_s\": %.6f, \"compute_imbalance\": %.4f, \"compute_lost_fraction\": %.4f, "
+            "\"mpi_fraction\": %.4f, \"barrier_wait_max_s\": %.6f, \"barrier_wait_min_s\": %.6f}\n}\n",
+            compute_max, compute_avg, compute_min, imbalance, lost, mpi_fraction,
+            barrier_max, barrier_min);
+    fclose(json);
+
+    // Resumen en una línea para run.sh (sin "Time:", que marca el tiempo de la ejecución)
+    printf("Profile: compute max %.6f s - avg %.6f s - imbalance %.2f%% - MPI %.2f%% - "
+           "barrier wait max %.6f s - %s.csv %s.json\n",
+           compute_max, compute_avg, 100.0 * imbalance, 100.0 * mpi_fraction, barrier_max,
+           prefix, prefix);
+    fflush(stdout);
+}
+
+int MPI_Finalize(void) {
+    int rank, size, len;
+    stats[STAT_WALL] = PMPI_Wtime() - init_time;
+    comm_info(MPI_COMM_WORLD, &rank, &size);
+
+    char host[MPI_MAX_PROCESSOR_NAME];
+    memset(host, 0, sizeof(host));
+    PMPI_Get_processor_name(host, &len);
+
+    double* all = NULL;
+    char* hosts = NULL;
+    if (rank == 0) {
+        all = (double*) malloc((size_t) size * STATS_LEN * sizeof(double));
+        hosts = (char*) malloc((size_t) size * MPI_MAX_PROCESSOR_NAME);
+        if (!all || !hosts) {
+            perror("Error al asignar memoria");
+            PMPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    PMPI_Gather(stats, STATS_LEN, MPI_DOUBLE, all, STATS_LEN, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    PMPI_Gather(host, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, hosts, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        const char* prefix = getenv("HPC_PROFILE");
+        write_report(prefix && prefix[0] ? prefix : "mpi_profile", all, hosts, size);
+        free(all);
+        free(hosts);
+    }
+    return PMPI_Finalize();
+}
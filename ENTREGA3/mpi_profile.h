@@ -0,0 +1,16 @@
+#ifndef MPI_PROFILE_H_
+#define MPI_PROFILE_H_
+
+#include <mpi.h>
+
+/*
+ * Niveles de MPI_Pcontrol con los que matrix_mpi marca sus tramos de cómputo
+ * (productos locales y acumulación de paneles). mpi_profile.c mide el tiempo
+ * entre PROFILE_COMPUTE_BEGIN y PROFILE_COMPUTE_END; los tramos pueden
+ * anidarse y cuenta el más externo. Sin la capa de perfilado MPI_Pcontrol
+ * no hace nada. Los niveles 0 a 2 los define el estándar y no se usan.
+ */
+#define PROFILE_COMPUTE_BEGIN 10
+#define PROFILE_COMPUTE_END 11
+
+#endif /* MPI_PROFILE_H_ */
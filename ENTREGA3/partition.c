@@ -0,0 +1,71 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "partition.h"
+
+static void partition_alloc(RowPartition* p, int n, int parts) {
+    p->n = n;
+    p->parts = parts;
+    p->start = (int*) malloc((parts + 1) * sizeof(int));
+    if (!p->start) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void partition_uniform(RowPartition* p, int n, int parts) {
+    partition_alloc(p, n, parts);
+    for (int r = 0; r <= parts; r++) {
+        p->start[r] = (int) ((long) n * r / parts);
+    }
+}
+
+int partition_weighted(RowPartition* p, int n, int parts, const double* weights) {
+    double total = 0.0;
+    for (int r = 0; r < parts; r++) {
+        if (!isfinite(weights[r]) || weights[r] < 0.0) return -1;
+        total += weights[r];
+    }
+    if (total <= 0.0) return -1;
+
+    // Redondeo de los inicios acumulados: las franjas suman n y el error de
+    // cada una es menor que una fila
+    partition_alloc(p, n, parts);
+    double acc = 0.0;
+    p->start[0] = 0;
+    for (int r = 1; r < parts; r++) {
+        acc += weights[r - 1];
+        p->start[r] = (int) floor(n * (acc / total) + 0.5);
+    }
+    p->start[parts] = n;
+    return 0;
+}
+
+int partition_read_weights(const char* path, int parts, double* weights) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) return -1;
+
+    char line[256];
+    int count = 0;
+    while (count < parts && fgets(line, sizeof(line), fp)) {
+        char* end;
+        double w = strtod(line, &end);
+        if (end == line) continue;    // Línea vacía o comentario
+        weights[count++] = w;
+    }
+    fclose(fp);
+    return count;
+}
+
+void partition_counts(const RowPartition* p, int row_len, int* counts, int* displs) {
+    for (int r = 0; r < p->parts; r++) {
+        counts[r] = PARTITION_ROWS(p, r) * row_len;
+        displs[r] = p->start[r] * row_len;
+    }
+}
+
+void partition_free(RowPartition* p) {
+    free(p->start);
+    p->start = NULL;
+}
@@ -0,0 +1,39 @@
+#ifndef PARTITION_H_
+#define PARTITION_H_
+
+/*
+ * Reparto de las n filas de una matriz entre `parts` rangos en franjas
+ * contiguas: el rango r tiene las filas [start[r], start[r + 1]). El mismo
+ * reparto se usa para calcular, repartir A y reunir C, de modo que los
+ * cálculos y los counts/displs de las colectivas no pueden discrepar.
+ *
+ * Con pesos (p. ej. GFLOP/s medidos en cada rango) cada franja es
+ * proporcional a su peso, para que en un clúster heterogéneo los nodos
+ * rápidos reciban más filas que los lentos.
+ */
+typedef struct {
+    int n;
+    int parts;
+    int* start;     // parts + 1 inicios, start[0] = 0 y start[parts] = n
+} RowPartition;
+
+#define PARTITION_ROWS(p, r) ((p)->start[(r) + 1] - (p)->start[(r)])
+
+// Reparto uniforme: la franja r empieza en n * r / parts
+void partition_uniform(RowPartition* p, int n, int parts);
+
+// Reparto proporcional a weights[0..parts). Devuelve -1 si algún peso es
+// negativo o no finito, o si todos son 0.
+int partition_weighted(RowPartition* p, int n, int parts, const double* weights);
+
+// Lee `parts` pesos de un archivo de texto: un número por línea, en el orden
+// de los rangos; se ignoran las líneas vacías y las que empiezan por '#'.
+// Devuelve el número de pesos leídos o -1 si el archivo no se puede abrir.
+int partition_read_weights(const char* path, int parts, double* weights);
+
+// Cuentas y desplazamientos para una colectiva con filas de row_len elementos
+void partition_counts(const RowPartition* p, int row_len, int* counts, int* displs);
+
+void partition_free(RowPartition* p);
+
+#endif /* PARTITION_H_ */
@@ -9,6 +9,12 @@ SIZES=(10 100 200 400 800 1600 3200)
 PROCESSES=(2 4 8 16 32)
 HOSTFILE="hosts.txt"
 RUNS=3  # Número de ejecuciones por configuración para promediar
+COMUN_DIR="../comun"  # Módulo compartido de kernels GEMM
+GEMM_ARGS=""  # Opciones de kernel para ambos binarios (p. ej. --kernel=bloques)
+MPI_ARGS=""   # Opciones sólo de matrix_mpi (p. ej. --mode=summa)
+THREADS=1            # Hilos OpenMP por rango (modo híbrido)
+RANKS_PER_NODE=""    # Rangos por nodo (vacío: los slots del hostfile)
+PROFILE=0            # 1: usar matrix_mpi_prof (capa PMPI) y guardar perfiles en results/
 
 # Archivos de salida
 RESULTS_CSV="results.csv"
@@ -19,7 +25,8 @@ mkdir -p results
 
 # Función para logging
 log() {
-    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $1" | tee -a $LOG_FILE
+    # A stderr: run_sequential y run_mpi devuelven sus resultados por stdout
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $1" | tee -a $LOG_FILE >&2
 }
 
 # Función para verificar que los ejecutables existen
@@ -34,6 +41,11 @@ check_executables() {
         exit 1
     fi
     
+    if [ "$PROFILE" -eq 1 ] && [ ! -f "./matrix_mpi_prof" ]; then
+        log "ERROR: matrix_mpi_prof executable not found (compile with -c)"
+        exit 1
+    fi
+    
     if [ ! -f "$HOSTFILE" ]; then
         log "ERROR: hostfile $HOSTFILE not found"
         exit 1
@@ -43,21 +55,31 @@ check_executables() {
 # Función para compilar los programas
 compile_programs() {
     log "Compiling programs..."
+    local comun_src="$COMUN_DIR/matriz.c $COMUN_DIR/gemm.c $COMUN_DIR/gemm_bloques.c \
+        $COMUN_DIR/gemm_empaquetado.c $COMUN_DIR/gemm_strassen.c $COMUN_DIR/micronucleos_x86.c \
+        $COMUN_DIR/simd.c"
     
     # Compilar versión secuencial
-    gcc -O3 -o matrix_sequential matrix_sequential.c -lm
+    gcc -O3 -o matrix_sequential matriz_secuencial_modified.c $comun_src -lm
     if [ $? -ne 0 ]; then
         log "ERROR: Failed to compile sequential version"
         exit 1
     fi
     
     # Compilar versión MPI
-    mpicc -O3 -o matrix_mpi matrix_mpi.c -lm
+    mpicc -O3 -fopenmp -o matrix_mpi matrix_mpi.c matrix_io.c partition.c $comun_src -lm
     if [ $? -ne 0 ]; then
         log "ERROR: Failed to compile MPI version"
         exit 1
     fi
     
+    # Compilar versión MPI con la capa de perfilado PMPI
+    mpicc -O3 -fopenmp -o matrix_mpi_prof matrix_mpi.c matrix_io.c partition.c mpi_profile.c $comun_src -lm
+    if [ $? -ne 0 ]; then
+        log "ERROR: Failed to compile profiled MPI version"
+        exit 1
+    fi
+    
     log "Compilation successful"
 }
 
@@ -68,7 +90,7 @@ run_sequential() {
     
     local total_time=0
     for ((i=1; i<=RUNS; i++)); do
-        local output=$(./matrix_sequential $size 2>&1)
+        local output=$(./matrix_sequential $size $GEMM_ARGS 2>&1)
         local time=$(echo "$output" | grep "Sequential Time:" | awk '{print $3}')
         
         if [ -z "$time" ]; then
@@ -93,14 +115,40 @@ run_mpi() {
     
     local total_time=0
     local successful_runs=0
+    local total_imbalance=0
+    local total_mpi=0
+
+    # Con perfilado cada ejecución deja results/profile_<n>_<p>_<i>.{csv,json}
+    local binary=./matrix_mpi
+    if [ "$PROFILE" -eq 1 ]; then
+        binary=./matrix_mpi_prof
+    fi
+
+    # Modo híbrido: R rangos por nodo, cada uno con THREADS núcleos para sus hilos
+    local mapping=()
+    if [ -n "$RANKS_PER_NODE" ]; then
+        mapping=(--map-by "ppr:$RANKS_PER_NODE:node:PE=$THREADS")
+    elif [ "$THREADS" -gt 1 ]; then
+        mapping=(--map-by "slot:PE=$THREADS")
+    fi
     
     for ((i=1; i<=RUNS; i++)); do
-        local output=$(mpirun -np $proc -hostfile $HOSTFILE ./matrix_mpi $size 2>&1)
-        local time=$(echo "$output" | grep "Time:" | tail -1 | awk '{print $NF}')
+        local output=$(HPC_PROFILE="results/profile_${size}_${proc}_$i" \
+            mpirun -np $proc -hostfile $HOSTFILE "${mapping[@]}" -x OMP_NUM_THREADS=$THREADS -x HPC_PROFILE \
+            $binary $size $GEMM_ARGS $MPI_ARGS --threads=$THREADS 2>&1)
+        local time=$(echo "$output" | grep "Time:" | tail -1 | awk '{print $(NF-1)}')
         
         if [ ! -z "$time" ] && [ "$time" != "0.000000" ]; then
             total_time=$(echo "$total_time + $time" | bc -l)
             ((successful_runs++))
+            # Desbalance de cómputo y fracción de tiempo en MPI de la línea "Profile:"
+            local profile=$(echo "$output" | grep "^Profile:" | tail -1)
+            if [ -n "$profile" ]; then
+                local imbalance=$(echo "$profile" | sed -n 's/.*imbalance \([0-9.]*\)%.*/\1/p')
+                local mpi_pct=$(echo "$profile" | sed -n 's/.* MPI \([0-9.]*\)%.*/\1/p')
+                total_imbalance=$(echo "$total_imbalance + $imbalance" | bc -l)
+                total_mpi=$(echo "$total_mpi + $mpi_pct" | bc -l)
+            fi
         else
             log "WARNING: Failed run $i for Size=$size, Processes=$proc"
         fi
@@ -113,7 +161,13 @@ run_mpi() {
     fi
     
     local avg_time=$(echo "scale=6; $total_time / $successful_runs" | bc -l)
-    echo $avg_time
+    if [ "$PROFILE" -eq 1 ]; then
+        local avg_imbalance=$(echo "scale=2; $total_imbalance / $successful_runs" | bc -l)
+        local avg_mpi=$(echo "scale=2; $total_mpi / $successful_runs" | bc -l)
+        echo "$avg_time $avg_imbalance $avg_mpi"
+    else
+        echo "$avg_time NA NA"
+    fi
 }
 
 # Función principal de experimentación
@@ -121,7 +175,7 @@ run_experiments() {
     log "Starting matrix multiplication experiments"
     
     # Crear archivo CSV con headers
-    echo "Matrix_Size,Processes,Execution_Time,Speedup,Efficiency,Sequential_Time" > $RESULTS_CSV
+    echo "Matrix_Size,Processes,Execution_Time,Speedup,Efficiency,Sequential_Time,Threads_Per_Process,Compute_Imbalance_Pct,MPI_Time_Pct" > $RESULTS_CSV
     
     for size in "${SIZES[@]}"; do
         log "Processing matrix size: $size"
@@ -145,7 +199,7 @@ run_experiments() {
                 log "WARNING: Requested $proc processes but only $total_slots slots available"
             fi
             
-            mpi_time=$(run_mpi $size $proc)
+            read mpi_time imbalance mpi_pct <<< "$(run_mpi $size $proc)"
             
             if [ "$mpi_time" == "0" ]; then
                 log "ERROR: MPI execution failed for Size=$size, Processes=$proc"
@@ -154,12 +208,13 @@ run_experiments() {
             
             # Calcular métricas
             speedup=$(echo "scale=6; $seq_time / $mpi_time" | bc -l)
-            efficiency=$(echo "scale=6; $speedup / $proc" | bc -l)
+            # La eficiencia se mide sobre los núcleos usados (rangos x hilos)
+            efficiency=$(echo "scale=6; $speedup / ($proc * $THREADS)" | bc -l)
             
             # Guardar resultados
-            echo "$size,$proc,$mpi_time,$speedup,$efficiency,$seq_time" >> $RESULTS_CSV
+            echo "$size,$proc,$mpi_time,$speedup,$efficiency,$seq_time,$THREADS,$imbalance,$mpi_pct" >> $RESULTS_CSV
             
-            log "Results: Size=$size, Proc=$proc, Time=$mpi_time, Speedup=$speedup, Efficiency=$efficiency"
+            log "Results: Size=$size, Proc=$proc, Time=$mpi_time, Speedup=$speedup, Efficiency=$efficiency, Imbalance=$imbalance%, MPI=$mpi_pct%"
         done
     done
     
@@ -182,7 +237,7 @@ EOF
 
     # Encontrar mejores configuraciones
     echo "Best Speedup Configurations:" >> performance_report.txt
-    sort -t',' -k4 -nr $RESULTS_CSV | head -5 | while IFS=',' read size proc time speedup eff seq_time; do
+    sort -t',' -k4 -nr $RESULTS_CSV | head -5 | while IFS=',' read size proc time speedup eff seq_time threads imbalance mpi_pct; do
         if [ "$size" != "Matrix_Size" ]; then
             echo "  Size: ${size}x${size}, Processes: $proc, Speedup: $speedup" >> performance_report.txt
         fi
@@ -190,7 +245,7 @@ EOF
     
     echo "" >> performance_report.txt
     echo "Best Efficiency Configurations:" >> performance_report.txt
-    sort -t',' -k5 -nr $RESULTS_CSV | head -5 | while IFS=',' read size proc time speedup eff seq_time; do
+    sort -t',' -k5 -nr $RESULTS_CSV | head -5 | while IFS=',' read size proc time speedup eff seq_time threads imbalance mpi_pct; do
         if [ "$size" != "Matrix_Size" ]; then
             echo "  Size: ${size}x${size}, Processes: $proc, Efficiency: $eff" >> performance_report.txt
         fi
@@ -216,11 +271,20 @@ Options:
     -s, --sizes     Specify matrix sizes (default: 10 100 200 400 800 1600 3200)
     -p, --processes Specify process counts (default: 2 4 8 16 32)
     -r, --runs      Number of runs per configuration (default: 3)
+    -k, --kernel    GEMM kernel: ingenuo | bloques | empaquetado (default: empaquetado)
+    -b, --blocks    Block sizes L1,L2,L3 for the blocked kernel (default: from sysfs)
+    -m, --mode      MPI distribution: rows | summa | pipeline | shared (default: rows)
+    -t, --threads   OpenMP threads per MPI process, hybrid mode (default: 1)
+    -n, --ranks-per-node  MPI processes per node (default: hostfile slots)
+    -w, --weights   Row weights for rows/pipeline modes: FILE (one per rank) | calibrate
+    -P, --profile   Run the PMPI-profiled binary; per-rank CSV/JSON go to results/
 
 Examples:
     $0                          # Run with default parameters
     $0 -c                       # Compile and run
     $0 -s "100 400 800" -p "2 4 8"  # Custom sizes and processes
+    $0 -p "2 4" -n 1 -t 16      # Hybrid: 1 process per node, 16 threads each
+    $0 -p "8" -w calibrate      # Rows proportional to each rank's measured GFLOP/s
 EOF
 }
 
@@ -247,6 +311,34 @@ while [[ $# -gt 0 ]]; do
             RUNS="$2"
             shift 2
             ;;
+        -k|--kernel)
+            GEMM_ARGS="$GEMM_ARGS --kernel=$2"
+            shift 2
+            ;;
+        -b|--blocks)
+            GEMM_ARGS="$GEMM_ARGS --bloques=$2"
+            shift 2
+            ;;
+        -m|--mode)
+            MPI_ARGS="$MPI_ARGS --mode=$2"
+            shift 2
+            ;;
+        -t|--threads)
+            THREADS="$2"
+            shift 2
+            ;;
+        -n|--ranks-per-node)
+            RANKS_PER_NODE="$2"
+            shift 2
+            ;;
+        -w|--weights)
+            MPI_ARGS="$MPI_ARGS --weights=$2"
+            shift 2
+            ;;
+        -P|--profile)
+            PROFILE=1
+            shift
+            ;;
         *)
             log "Unknown option: $1"
             show_help
@@ -258,7 +350,7 @@ done
 # Función principal
 main() {
     log "Starting matrix multiplication performance evaluation"
-    log "Configuration: Sizes=(${SIZES[*]}), Processes=(${PROCESSES[*]}), Runs=$RUNS"
+    log "Configuration: Sizes=(${SIZES[*]}), Processes=(${PROCESSES[*]}), Runs=$RUNS, Kernel=(${GEMM_ARGS:-empaquetado}), MPI=(${MPI_ARGS:-rows}), Threads=$THREADS, Ranks_Per_Node=${RANKS_PER_NODE:-slots}, Profile=$PROFILE"
     
     # Verificar prerrequisitos
     check_executables
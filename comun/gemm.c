@@ -0,0 +1,198 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gemm.h"
+
+#define RUTA_CACHE "/sys/devices/system/cpu/cpu0/cache"
+
+// Tamaños por defecto si sysfs no está disponible (bytes)
+#define CACHE_L1_DEFECTO (32UL * 1024)
+#define CACHE_L2_DEFECTO (1024UL * 1024)
+#define CACHE_L3_DEFECTO (8UL * 1024 * 1024)
+
+// Múltiplo al que se redondean los lados: una línea de caché de int
+#define LADO_MINIMO 16
+
+// Función para leer una línea de un archivo de sysfs
+static int leer_sysfs(const char* ruta, char* buf, size_t tam) {
+    FILE* fp = fopen(ruta, "r");
+    if (!fp) return -1;
+    if (!fgets(buf, (int) tam, fp)) {
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+    buf[strcspn(buf, "\n")] = '\0';
+    return 0;
+}
+
+// Función para interpretar tamaños como "48K" o "105M"
+static size_t parsear_tamano(const char* texto) {
+    char* fin;
+    size_t valor = strtoul(texto, &fin, 10);
+    if (*fin == 'K') valor *= 1024;
+    else if (*fin == 'M') valor *= 1024 * 1024;
+    return valor;
+}
+
+// Lado de un bloque cuadrado tal que tres bloques (A, B y C) quepan en la caché
+static int lado_para_cache(size_t bytes, size_t tam_elem) {
+    int lado = (int) sqrt((double) bytes / (3.0 * tam_elem));
+    lado = lado / LADO_MINIMO * LADO_MINIMO;
+    return lado < LADO_MINIMO ? LADO_MINIMO : lado;
+}
+
+// Ajusta los lados para que cada nivel sea múltiplo del anterior
+static void normalizar_bloques(TamBloques* t) {
+    if (t->l2 < t->l1) t->l2 = t->l1;
+    t->l2 = t->l2 / t->l1 * t->l1;
+    if (t->l3 < t->l2) t->l3 = t->l2;
+    t->l3 = t->l3 / t->l2 * t->l2;
+}
+
+void detectar_caches(size_t bytes[3]) {
+    static size_t caches[4] = {0, CACHE_L1_DEFECTO, CACHE_L2_DEFECTO, CACHE_L3_DEFECTO};
+    static int leidas = 0;
+    char ruta[256], nivel[32], tipo[32], tam[32];
+
+    if (leidas) {
+        memcpy(bytes, caches + 1, 3 * sizeof(size_t));
+        return;
+    }
+
+    for (int idx = 0; idx < 8; idx++) {
+        snprintf(ruta, sizeof(ruta), RUTA_CACHE "/index%d/level", idx);
+        if (leer_sysfs(ruta, nivel, sizeof(nivel)) != 0) break;
+        snprintf(ruta, sizeof(ruta), RUTA_CACHE "/index%d/type", idx);
+        if (leer_sysfs(ruta, tipo, sizeof(tipo)) != 0) continue;
+        snprintf(ruta, sizeof(ruta), RUTA_CACHE "/index%d/size", idx);
+        if (leer_sysfs(ruta, tam, sizeof(tam)) != 0) continue;
+
+        int l = atoi(nivel);
+        if (l < 1 || l > 3 || strcmp(tipo, "Instruction") == 0) continue;
+        size_t tam_cache = parsear_tamano(tam);
+        if (tam_cache > 0) caches[l] = tam_cache;
+    }
+    leidas = 1;
+    memcpy(bytes, caches + 1, 3 * sizeof(size_t));
+}
+
+void detectar_bloques(TamBloques* t, size_t tam_elem) {
+    size_t caches[3];
+    detectar_caches(caches);
+    t->l1 = lado_para_cache(caches[0], tam_elem);
+    t->l2 = lado_para_cache(caches[1], tam_elem);
+    t->l3 = lado_para_cache(caches[2], tam_elem);
+    normalizar_bloques(t);
+}
+
+int parsear_bloques(const char* texto, TamBloques* t) {
+    TamBloques nuevo;
+    if (sscanf(texto, "%d,%d,%d", &nuevo.l1, &nuevo.l2, &nuevo.l3) != 3) return -1;
+    if (nuevo.l1 <= 0 || nuevo.l2 <= 0 || nuevo.l3 <= 0) return -1;
+    normalizar_bloques(&nuevo);
+    *t = nuevo;
+    return 0;
+}
+
+const char* nombre_kernel(TipoKernel kernel) {
+    switch (kernel) {
+        case KERNEL_INGENUO: return "ingenuo";
+        case KERNEL_BLOQUES: return "bloques";
+        case KERNEL_EMPAQUETADO: return "empaquetado";
+    }
+    return "desconocido";
+}
+
+static int parsear_kernel(const char* texto, TipoKernel* kernel) {
+    static const TipoKernel todos[] = {KERNEL_INGENUO, KERNEL_BLOQUES, KERNEL_EMPAQUETADO};
+    for (size_t i = 0; i < sizeof(todos) / sizeof(todos[0]); i++) {
+        if (strcmp(texto, nombre_kernel(todos[i])) == 0) {
+            *kernel = todos[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+void opciones_gemm_defecto(OpcionesGemm* op, size_t tam_elem) {
+    op->kernel = KERNEL_INGENUO;
+    detectar_bloques(&op->bloques, tam_elem);
+}
+
+int parsear_opcion_gemm(const char* arg, OpcionesGemm* op) {
+    if (strncmp(arg, "--kernel=", 9) == 0) {
+        if (parsear_kernel(arg + 9, &op->kernel) != 0) {
+            fprintf(stderr, "Kernel desconocido: %s\n", arg + 9);
+            return -1;
+        }
+        return 1;
+    }
+    if (strncmp(arg, "--bloques=", 10) == 0) {
+        if (parsear_bloques(arg + 10, &op->bloques) != 0) {
+            fprintf(stderr, "Tamaños de bloque inválidos: %s\n", arg + 10);
+            return -1;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+int parsear_opciones_gemm(int argc, char** argv, int primero,
+                          OpcionesGemm* op) {
+    for (int i = primero; i < argc; i++) {
+        int r = parsear_opcion_gemm(argv[i], op);
+        if (r < 0) return -1;
+        if (r == 0) {
+            fprintf(stderr, "Opción desconocida: %s\n", argv[i]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void producto_linea_int(int k, const int* restrict a, const int* restrict B, int ldb,
+                        int* restrict c, int ancho) {
+    int acc[ELEMS_LINEA_INT] = {0};
+
+    if (ancho == ELEMS_LINEA_INT) {
+        // Ancho fijo: el compilador mantiene acc en uno o dos registros vectoriales
+        for (int p = 0; p < k; p++) {
+            int ap = a[p];
+            const int* restrict b = B + (size_t) p * ldb;
+            for (int v = 0; v < ELEMS_LINEA_INT; v++) {
+                acc[v] += ap * b[v];
+            }
+        }
+    } else {
+        for (int p = 0; p < k; p++) {
+            int ap = a[p];
+            const int* restrict b = B + (size_t) p * ldb;
+            for (int v = 0; v < ancho; v++) {
+                acc[v] += ap * b[v];
+            }
+        }
+    }
+    for (int v = 0; v < ancho; v++) {
+        c[v] = acc[v];
+    }
+}
+
+void multiplicar_int(const OpcionesGemm* op, int m, int n, int k,
+                     const int* A, int lda, const int* B, int ldb, int* C, int ldc) {
+    if (op->kernel == KERNEL_EMPAQUETADO)
+        multiplicar_empaquetado_int(m, n, k, A, lda, B, ldb, C, ldc);
+    else
+        multiplicar_bloques_int(m, n, k, A, lda, B, ldb, C, ldc, &op->bloques);
+}
+
+void multiplicar_double(const OpcionesGemm* op, int m, int n, int k,
+                        const double* A, int lda, const double* B, int ldb,
+                        double* C, int ldc) {
+    if (op->kernel == KERNEL_EMPAQUETADO)
+        multiplicar_empaquetado_double(m, n, k, A, lda, B, ldb, C, ldc);
+    else
+        multiplicar_bloques_double(m, n, k, A, lda, B, ldb, C, ldc, &op->bloques);
+}
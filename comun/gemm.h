@@ -0,0 +1,184 @@
+#ifndef GEMM_H_
+#define GEMM_H_
+
+#include <stddef.h>
+
+/*
+ * Kernels de multiplicación C = A * B sobre matrices por filas con dimensión
+ * principal explícita (lda, ldb, ldc). A es m x k, B es k x n y C es m x n.
+ * Los kernels sobrescriben C, de modo que cada hilo o proceso puede pasar
+ * sólo su franja de filas (A + i0*lda, C + i0*ldc, m = filas propias).
+ */
+
+// Kernels seleccionables desde la línea de comandos (--kernel=...)
+typedef enum {
+    KERNEL_INGENUO,     // Triple bucle i-j-k original
+    KERNEL_BLOQUES,     // Bloques multinivel L1/L2/L3
+    KERNEL_EMPAQUETADO  // Paneles empaquetados + micronúcleo SIMD
+} TipoKernel;
+
+// Lado de los bloques (en elementos) para cada nivel de caché
+typedef struct {
+    int l1, l2, l3;
+} TamBloques;
+
+typedef struct {
+    TipoKernel kernel;
+    TamBloques bloques;
+} OpcionesGemm;
+
+// Tamaño en bytes de las cachés L1 de datos, L2 y L3 según
+// /sys/devices/system/cpu/cpu0/cache (valores por defecto si no existe)
+void detectar_caches(size_t bytes[3]);
+
+// Tamaños de bloque a partir de las cachés detectadas
+void detectar_bloques(TamBloques* t, size_t tam_elem);
+
+// Interpreta "L1,L2,L3" (por ejemplo "64,256,1024"). Devuelve 0 si es válido.
+int parsear_bloques(const char* texto, TamBloques* t);
+
+// Valores por defecto: kernel ingenuo y bloques detectados
+void opciones_gemm_defecto(OpcionesGemm* op, size_t tam_elem);
+
+// Procesa una opción. Devuelve 1 si la reconoce, 0 si no es de GEMM
+// (el programa puede tener opciones propias) y -1 si el valor es inválido.
+int parsear_opcion_gemm(const char* arg, OpcionesGemm* op);
+
+// Procesa las opciones --kernel= y --bloques= a partir de argv[primero]
+// sobre op, que debe venir inicializado (opciones_gemm_defecto).
+// Devuelve 0 si todas son válidas; en caso contrario imprime el error y -1.
+int parsear_opciones_gemm(int argc, char** argv, int primero, OpcionesGemm* op);
+
+const char* nombre_kernel(TipoKernel kernel);
+
+#define OPCIONES_GEMM_USO "[--kernel=ingenuo|bloques|empaquetado] [--bloques=L1,L2,L3]"
+
+void multiplicar_bloques_int(int m, int n, int k,
+                             const int* A, int lda, const int* B, int ldb,
+                             int* C, int ldc, const TamBloques* t);
+void multiplicar_bloques_float(int m, int n, int k,
+                               const float* A, int lda, const float* B, int ldb,
+                               float* C, int ldc, const TamBloques* t);
+void multiplicar_bloques_double(int m, int n, int k,
+                                const double* A, int lda, const double* B, int ldb,
+                                double* C, int ldc, const TamBloques* t);
+
+// Igual que multiplicar_bloques pero acumula: C += A * B
+void acumular_bloques_int(int m, int n, int k,
+                          const int* A, int lda, const int* B, int ldb,
+                          int* C, int ldc, const TamBloques* t);
+void acumular_bloques_float(int m, int n, int k,
+                            const float* A, int lda, const float* B, int ldb,
+                            float* C, int ldc, const TamBloques* t);
+void acumular_bloques_double(int m, int n, int k,
+                             const double* A, int lda, const double* B, int ldb,
+                             double* C, int ldc, const TamBloques* t);
+
+// Motor recursivo con tareas OpenMP: parte (M, N, K) por la mitad en cada
+// dimensión mayor que `corte` (C en cuadrantes, cada uno una tarea) hasta que
+// las tres caben en `corte`, y resuelve las hojas con el kernel por bloques.
+// Las dos mitades de K escriben el mismo cuadrante de C y se ordenan con
+// depend. Abre su propia región paralela de num_hilos hilos; compilado sin
+// -fopenmp se ejecuta la misma recursión en serie.
+#define CORTE_TAREAS_DEFECTO 128
+void multiplicar_tareas_int(int m, int n, int k,
+                            const int* A, int lda, const int* B, int ldb,
+                            int* C, int ldc, int corte, int num_hilos, const TamBloques* t);
+void multiplicar_tareas_double(int m, int n, int k,
+                               const double* A, int lda, const double* B, int ldb,
+                               double* C, int ldc, int corte, int num_hilos, const TamBloques* t);
+
+/*
+ * Strassen-Winograd (7 productos y 15 sumas por nivel) para matrices
+ * cuadradas. n se rellena con ceros hasta N = s * 2^d con s <= corte y la
+ * recursión baja hasta el corte, donde usa el kernel clásico de op (bloques
+ * o empaquetado; el ingenuo se sustituye por bloques).
+ * Toda la memoria de trabajo (copias con relleno, temporales de cada nivel y,
+ * con el kernel empaquetado, los paneles de cada hoja) se reserva una sola vez
+ * en el plan; la recursión no llama a malloc.
+ * En los `niveles` superiores los siete productos son tareas OpenMP, cada
+ * una con su parte de la arena.
+ */
+typedef struct {
+    int n;              // Tamaño pedido
+    int N;              // Tamaño con relleno
+    int corte;          // Lado a partir del cual se usa el kernel clásico
+    int niveles;        // Niveles con los siete productos en paralelo
+    int num_hilos;
+    size_t tam_elem;
+    size_t elems_hoja;  // Paneles del kernel empaquetado por hoja (0 con bloques)
+    void* arena;
+    size_t bytes;
+    int mapeada;
+} PlanStrassen;
+
+#define CORTE_STRASSEN_DEFECTO 256
+
+// num_hilos = 1 recorre la recursión en serie (arena mínima). op es el que
+// se pasará a multiplicar_strassen: decide si las hojas necesitan paneles.
+PlanStrassen crear_plan_strassen(int n, int corte, int num_hilos, size_t tam_elem,
+                                 const OpcionesGemm* op);
+void liberar_plan_strassen(PlanStrassen* plan);
+
+// C = A * B con el plan (creado con el mismo tam_elem y kernel)
+void multiplicar_strassen_int(const PlanStrassen* plan, const int* A, int lda,
+                              const int* B, int ldb, int* C, int ldc, const OpcionesGemm* op);
+void multiplicar_strassen_double(const PlanStrassen* plan, const double* A, int lda,
+                                 const double* B, int ldb, double* C, int ldc,
+                                 const OpcionesGemm* op);
+
+// Corte automático: primer lado s (64, 128, ..., < n) desde el que un nivel
+// de Strassen sobre 2s x 2s es más rápido que el kernel clásico de op en dos
+// tamaños seguidos (o en el último probado). Si no hay ninguno devuelve n.
+int calibrar_corte_strassen_int(int n, int num_hilos, const OpcionesGemm* op);
+int calibrar_corte_strassen_double(int n, int num_hilos, const OpcionesGemm* op);
+
+// Motor empaquetado: paneles de A y B contiguos y micronúcleo AVX2/AVX-512
+// (o escalar) elegido en tiempo de ejecución con CPUID
+void multiplicar_empaquetado_int(int m, int n, int k,
+                                 const int* A, int lda, const int* B, int ldb,
+                                 int* C, int ldc);
+void multiplicar_empaquetado_float(int m, int n, int k,
+                                   const float* A, int lda, const float* B, int ldb,
+                                   float* C, int ldc);
+void multiplicar_empaquetado_double(int m, int n, int k,
+                                    const double* A, int lda, const double* B, int ldb,
+                                    double* C, int ldc);
+
+// Igual, con los paneles en memoria del llamador (no reserva): `paneles` debe
+// tener bytes_paneles_empaquetado(lado, tam_elem) bytes si m, n, k <= lado
+size_t bytes_paneles_empaquetado(int lado, size_t tam_elem);
+void multiplicar_empaquetado_paneles_int(int m, int n, int k,
+                                         const int* A, int lda, const int* B, int ldb,
+                                         int* C, int ldc, void* paneles);
+void multiplicar_empaquetado_paneles_float(int m, int n, int k,
+                                           const float* A, int lda, const float* B, int ldb,
+                                           float* C, int ldc, void* paneles);
+void multiplicar_empaquetado_paneles_double(int m, int n, int k,
+                                            const double* A, int lda, const double* B, int ldb,
+                                            double* C, int ldc, void* paneles);
+
+// Micronúcleo que usará el motor empaquetado (p. ej. "avx512 8x24")
+const char* descripcion_empaquetado_int(void);
+const char* descripcion_empaquetado_float(void);
+const char* descripcion_empaquetado_double(void);
+
+// Enteros por línea de caché de C (filas alineadas a 64 bytes)
+#define ELEMS_LINEA_INT 16
+
+// Calcula una línea de caché de C: c[0 .. ancho) = a[0 .. k) * B[0 .. k)[0 .. ancho),
+// con ancho <= ELEMS_LINEA_INT. La suma se acumula en registros (restrict evita
+// el aliasing con C) y la línea se escribe una sola vez: si cada hilo calcula
+// líneas completas, ningún par de hilos comparte líneas de C.
+void producto_linea_int(int k, const int* restrict a, const int* restrict B, int ldb,
+                        int* restrict c, int ancho);
+
+// Ejecuta el kernel de op (bloques o empaquetado). El ingenuo lo conserva
+// cada programa como referencia, por lo que aquí no se despacha.
+void multiplicar_int(const OpcionesGemm* op, int m, int n, int k,
+                     const int* A, int lda, const int* B, int ldb, int* C, int ldc);
+void multiplicar_double(const OpcionesGemm* op, int m, int n, int k,
+                        const double* A, int lda, const double* B, int ldb,
+                        double* C, int ldc);
+
+#endif /* GEMM_H_ */
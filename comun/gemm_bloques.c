@@ -0,0 +1,13 @@
+#include "gemm.h"
+
+#define TIPO int
+#define SUFIJO int
+#include "gemm_bloques_plantilla.h"
+
+#define TIPO float
+#define SUFIJO float
+#include "gemm_bloques_plantilla.h"
+
+#define TIPO double
+#define SUFIJO double
+#include "gemm_bloques_plantilla.h"
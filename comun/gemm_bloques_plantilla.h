@@ -0,0 +1,76 @@
+/*
+ * Plantilla del kernel por bloques. Se incluye una vez por tipo desde
+ * gemm_bloques.c con TIPO y SUFIJO definidos, por ejemplo:
+ *
+ *     #define TIPO double
+ *     #define SUFIJO double
+ *     #include "gemm_bloques_plantilla.h"
+ */
+
+#define UNIR_(a, b) a##_##b
+#define UNIR(a, b)  UNIR_(a, b)
+#define FN(nombre)  UNIR(nombre, SUFIJO)
+
+// Bloque del nivel más interno: orden i-k-j, recorrido unitario sobre B y C
+static void FN(nucleo_bloque)(const TIPO* restrict A, int lda,
+                              const TIPO* restrict B, int ldb,
+                              TIPO* restrict C, int ldc,
+                              int i0, int i1, int j0, int j1, int k0, int k1) {
+    for (int i = i0; i < i1; i++) {
+        TIPO* restrict c = C + (size_t) i * ldc;
+        for (int k = k0; k < k1; k++) {
+            TIPO a = A[(size_t) i * lda + k];
+            const TIPO* restrict b = B + (size_t) k * ldb;
+            for (int j = j0; j < j1; j++) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+
+// Recorre un nivel de bloques (2 = L3, 1 = L2, 0 = L1) y baja al siguiente
+static void FN(nivel_bloque)(const TIPO* A, int lda, const TIPO* B, int ldb,
+                             TIPO* C, int ldc, const int* lados, int nivel,
+                             int i0, int i1, int j0, int j1, int k0, int k1) {
+    if (nivel < 0) {
+        FN(nucleo_bloque)(A, lda, B, ldb, C, ldc, i0, i1, j0, j1, k0, k1);
+        return;
+    }
+    int b = lados[nivel];
+    for (int jj = j0; jj < j1; jj += b) {
+        int jf = jj + b < j1 ? jj + b : j1;
+        for (int kk = k0; kk < k1; kk += b) {
+            int kf = kk + b < k1 ? kk + b : k1;
+            for (int ii = i0; ii < i1; ii += b) {
+                int iff = ii + b < i1 ? ii + b : i1;
+                FN(nivel_bloque)(A, lda, B, ldb, C, ldc, lados, nivel - 1,
+                                 ii, iff, jj, jf, kk, kf);
+            }
+        }
+    }
+}
+
+void FN(acumular_bloques)(int m, int n, int k,
+                           const TIPO* A, int lda, const TIPO* B, int ldb,
+                           TIPO* C, int ldc, const TamBloques* t) {
+    int lados[3] = {t->l1, t->l2, t->l3};
+    FN(nivel_bloque)(A, lda, B, ldb, C, ldc, lados, 2, 0, m, 0, n, 0, k);
+}
+
+void FN(multiplicar_bloques)(int m, int n, int k,
+                             const TIPO* A, int lda, const TIPO* B, int ldb,
+                             TIPO* C, int ldc, const TamBloques* t) {
+    for (int i = 0; i < m; i++) {
+        TIPO* c = C + (size_t) i * ldc;
+        for (int j = 0; j < n; j++) {
+            c[j] = 0;
+        }
+    }
+    FN(acumular_bloques)(m, n, k, A, lda, B, ldb, C, ldc, t);
+}
+
+#undef FN
+#undef UNIR
+#undef UNIR_
+#undef TIPO
+#undef SUFIJO
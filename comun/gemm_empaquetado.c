@@ -0,0 +1,67 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "gemm.h"
+#include "matriz.h"
+#include "micronucleos.h"
+#include "simd.h"
+
+// Mayores mr y nr de los micronúcleos (AVX-512 int/float: 8 x 48)
+#define MR_MAXIMO 8
+#define NR_MAXIMO 48
+#define MICRO_MAX_ELEMENTOS (MR_MAXIMO * NR_MAXIMO)
+#define KC_MAXIMO 512
+#define ALINEACION_PANEL 64
+
+typedef struct {
+    int mc, kc, nc;
+} ParamsEmpaquetado;
+
+static int redondear(int valor, int multiplo, int minimo) {
+    valor = valor / multiplo * multiplo;
+    return valor < minimo ? minimo : valor;
+}
+
+/*
+ * Tamaños de panel a partir de las cachés: la tira de B (kc x nr) ocupa media
+ * L1, el bloque de A (mc x kc) media L2 y el panel de B (kc x nc) media L3.
+ */
+static void parametros_empaquetado(ParamsEmpaquetado* par, int mr, int nr, size_t tam_elem) {
+    size_t caches[3];
+    detectar_caches(caches);
+
+    par->kc = redondear((int) (caches[0] / 2 / (nr * tam_elem)), 8, 64);
+    if (par->kc > KC_MAXIMO) par->kc = KC_MAXIMO;
+    par->mc = redondear((int) (caches[1] / 2 / (par->kc * tam_elem)), mr, mr);
+    par->nc = redondear((int) (caches[2] / 2 / (par->kc * tam_elem)), nr, nr);
+    if (par->nc > 4096) par->nc = 4096 / nr * nr;
+}
+
+// Primera dirección alineada a ALINEACION_PANEL desde p
+static void* alinear_panel(void* p) {
+    uintptr_t u = (uintptr_t) p;
+    return (void*) ((u + ALINEACION_PANEL - 1) & ~(uintptr_t) (ALINEACION_PANEL - 1));
+}
+
+// Cota válida para cualquier micronúcleo: mc <= lado + mr, nc <= lado + nr,
+// kc <= min(lado, KC_MAXIMO), más la holgura para alinear los dos paneles
+size_t bytes_paneles_empaquetado(int lado, size_t tam_elem) {
+    size_t kc = lado < KC_MAXIMO ? (size_t) lado : KC_MAXIMO;
+    return (2 * (size_t) lado + MR_MAXIMO + NR_MAXIMO) * kc * tam_elem + 2 * ALINEACION_PANEL;
+}
+
+#define TIPO int
+#define SUFIJO int
+#define MICRO MicroInt
+#include "gemm_empaquetado_plantilla.h"
+
+#define TIPO float
+#define SUFIJO float
+#define MICRO MicroFloat
+#include "gemm_empaquetado_plantilla.h"
+
+#define TIPO double
+#define SUFIJO double
+#define MICRO MicroDouble
+#include "gemm_empaquetado_plantilla.h"
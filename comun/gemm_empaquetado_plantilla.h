@@ -0,0 +1,192 @@
+/*
+ * Plantilla del motor empaquetado (estilo GotoBLAS). Se incluye una vez por
+ * tipo desde gemm_empaquetado.c con TIPO, SUFIJO y MICRO definidos.
+ *
+ * Bucles (de fuera hacia dentro):
+ *   jc: paneles de NC columnas de B   (el panel empaquetado vive en L3)
+ *   pc: paneles de KC de profundidad  (B empaquetado: KC x NC)
+ *   ic: bloques de MC filas de A      (A empaquetado: MC x KC, vive en L2)
+ *   jr, ir: micronúcleo MR x NR sobre tiras contiguas (B en L1, C en registros)
+ */
+
+#define UNIR_(a, b) a##_##b
+#define UNIR(a, b)  UNIR_(a, b)
+#define FN(nombre)  UNIR(nombre, SUFIJO)
+
+#define MR_ESCALAR 4
+#define NR_ESCALAR 4
+
+// Micronúcleo escalar de respaldo (4 x 4)
+static void FN(micro_escalar)(int kc, const TIPO* restrict Ap, const TIPO* restrict Bp,
+                              TIPO* restrict C, int ldc) {
+    TIPO c[MR_ESCALAR][NR_ESCALAR] = {{0}};
+    for (int p = 0; p < kc; p++) {
+        for (int r = 0; r < MR_ESCALAR; r++) {
+            TIPO a = Ap[p * MR_ESCALAR + r];
+            for (int v = 0; v < NR_ESCALAR; v++) {
+                c[r][v] += a * Bp[p * NR_ESCALAR + v];
+            }
+        }
+    }
+    for (int r = 0; r < MR_ESCALAR; r++) {
+        for (int v = 0; v < NR_ESCALAR; v++) {
+            C[(size_t) r * ldc + v] += c[r][v];
+        }
+    }
+}
+
+// Micronúcleo según el conjunto de instrucciones disponible (CPUID)
+static MICRO FN(seleccionar_micro)(void) {
+    static const MICRO escalar = {MR_ESCALAR, NR_ESCALAR, FN(micro_escalar), "escalar 4x4"};
+#ifdef MICRONUCLEOS_X86
+    switch (detectar_simd()) {
+        case SIMD_AVX512: return UNIR(UNIR(micro, SUFIJO), avx512);
+        case SIMD_AVX2:   return UNIR(UNIR(micro, SUFIJO), avx2);
+        case SIMD_ESCALAR: break;
+    }
+#endif
+    return escalar;
+}
+
+const char* FN(descripcion_empaquetado)(void) {
+    return FN(seleccionar_micro)().nombre;
+}
+
+// Empaqueta A[mc x kc] en tiras de mr filas (columna a columna), con ceros al final
+static void FN(empaquetar_A)(int mc, int kc, const TIPO* A, int lda, int mr, TIPO* Ap) {
+    for (int ir = 0; ir < mc; ir += mr) {
+        int filas = mc - ir < mr ? mc - ir : mr;
+        for (int p = 0; p < kc; p++) {
+            for (int r = 0; r < filas; r++) {
+                *Ap++ = A[(size_t) (ir + r) * lda + p];
+            }
+            for (int r = filas; r < mr; r++) {
+                *Ap++ = 0;
+            }
+        }
+    }
+}
+
+// Empaqueta B[kc x nc] en tiras de nr columnas (fila a fila), con ceros al final
+static void FN(empaquetar_B)(int kc, int nc, const TIPO* B, int ldb, int nr, TIPO* Bp) {
+    for (int jr = 0; jr < nc; jr += nr) {
+        int cols = nc - jr < nr ? nc - jr : nr;
+        for (int p = 0; p < kc; p++) {
+            const TIPO* b = B + (size_t) p * ldb + jr;
+            for (int v = 0; v < cols; v++) {
+                *Bp++ = b[v];
+            }
+            for (int v = cols; v < nr; v++) {
+                *Bp++ = 0;
+            }
+        }
+    }
+}
+
+// Bytes de los paneles de A y B para un producto m x n x k, con la holgura
+// para alinear cada uno; en *bytesA los del panel de A
+static size_t FN(bytes_paneles)(int m, int n, int k, const MICRO* micro,
+                                const ParamsEmpaquetado* par, size_t* bytesA) {
+    int mr = micro->mr, nr = micro->nr;
+    int mc_max = m < par->mc ? (m + mr - 1) / mr * mr : par->mc;
+    int nc_max = n < par->nc ? (n + nr - 1) / nr * nr : par->nc;
+    int kc_max = k < par->kc ? k : par->kc;
+    *bytesA = (size_t) mc_max * kc_max * sizeof(TIPO);
+    return *bytesA + (size_t) nc_max * kc_max * sizeof(TIPO) + 2 * ALINEACION_PANEL;
+}
+
+// Producto con los paneles en `paneles` (al menos FN(bytes_paneles) bytes)
+static void FN(producto_empaquetado)(MICRO micro, ParamsEmpaquetado par,
+                                     int m, int n, int k, const TIPO* A, int lda,
+                                     const TIPO* B, int ldb, TIPO* C, int ldc, void* paneles) {
+    int mr = micro.mr, nr = micro.nr;
+
+    for (int i = 0; i < m; i++) {
+        TIPO* c = C + (size_t) i * ldc;
+        for (int j = 0; j < n; j++) {
+            c[j] = 0;
+        }
+    }
+    if (m == 0 || n == 0 || k == 0) return;
+
+    size_t bytesA;
+    FN(bytes_paneles)(m, n, k, &micro, &par, &bytesA);
+    TIPO* Ap = (TIPO*) alinear_panel(paneles);
+    TIPO* Bp = (TIPO*) alinear_panel((char*) Ap + bytesA);
+
+    // Bloque temporal para los bordes (m o n no múltiplos de mr, nr)
+    TIPO borde[MICRO_MAX_ELEMENTOS] __attribute__((aligned(64)));
+
+    for (int jc = 0; jc < n; jc += par.nc) {
+        int nc = n - jc < par.nc ? n - jc : par.nc;
+        for (int pc = 0; pc < k; pc += par.kc) {
+            int kc = k - pc < par.kc ? k - pc : par.kc;
+            FN(empaquetar_B)(kc, nc, B + (size_t) pc * ldb + jc, ldb, nr, Bp);
+
+            for (int ic = 0; ic < m; ic += par.mc) {
+                int mc = m - ic < par.mc ? m - ic : par.mc;
+                FN(empaquetar_A)(mc, kc, A + (size_t) ic * lda + pc, lda, mr, Ap);
+
+                for (int jr = 0; jr < nc; jr += nr) {
+                    int cols = nc - jr < nr ? nc - jr : nr;
+                    const TIPO* bp = Bp + (size_t) jr * kc;
+                    for (int ir = 0; ir < mc; ir += mr) {
+                        int filas = mc - ir < mr ? mc - ir : mr;
+                        const TIPO* ap = Ap + (size_t) ir * kc;
+                        TIPO* c = C + (size_t) (ic + ir) * ldc + jc + jr;
+
+                        if (filas == mr && cols == nr) {
+                            micro.fn(kc, ap, bp, c, ldc);
+                            continue;
+                        }
+                        for (int t = 0; t < mr * nr; t++) {
+                            borde[t] = 0;
+                        }
+                        micro.fn(kc, ap, bp, borde, nr);
+                        for (int r = 0; r < filas; r++) {
+                            for (int v = 0; v < cols; v++) {
+                                c[(size_t) r * ldc + v] += borde[r * nr + v];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void FN(multiplicar_empaquetado)(int m, int n, int k,
+                                 const TIPO* A, int lda, const TIPO* B, int ldb,
+                                 TIPO* C, int ldc) {
+    MICRO micro = FN(seleccionar_micro)();
+    ParamsEmpaquetado par;
+    parametros_empaquetado(&par, micro.mr, micro.nr, sizeof(TIPO));
+
+    int map;
+    size_t bytesA, bytes = FN(bytes_paneles)(m, n, k, &micro, &par, &bytesA);
+    void* paneles = reservar_alineado(bytes, &map);
+    if (!paneles) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    FN(producto_empaquetado)(micro, par, m, n, k, A, lda, B, ldb, C, ldc, paneles);
+    liberar_alineado(paneles, bytes, map);
+}
+
+void FN(multiplicar_empaquetado_paneles)(int m, int n, int k,
+                                         const TIPO* A, int lda, const TIPO* B, int ldb,
+                                         TIPO* C, int ldc, void* paneles) {
+    MICRO micro = FN(seleccionar_micro)();
+    ParamsEmpaquetado par;
+    parametros_empaquetado(&par, micro.mr, micro.nr, sizeof(TIPO));
+    FN(producto_empaquetado)(micro, par, m, n, k, A, lda, B, ldb, C, ldc, paneles);
+}
+
+#undef MR_ESCALAR
+#undef NR_ESCALAR
+#undef FN
+#undef UNIR
+#undef UNIR_
+#undef TIPO
+#undef SUFIJO
+#undef MICRO
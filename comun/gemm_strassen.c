@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "gemm.h"
+#include "matriz.h"
+
+#define CORTE_STRASSEN_MINIMO 16
+
+// Posición de cada temporal de un nivel en la arena
+enum { S1, S2, S3, S4, T1, T2, T3, T4, M1, M6, M7 };
+
+// Elementos de trabajo de un nivel de tamaño N: 11 bloques h x h (S1..S4,
+// T1..T4, M1, M6, M7) más la arena de los hijos (siete si van en paralelo).
+// Una hoja sólo necesita los paneles del kernel empaquetado.
+static size_t elementos_nivel(int N, const PlanStrassen* plan, int niveles) {
+    if (N <= plan->corte) return plan->elems_hoja;
+    int h = N / 2;
+    size_t hijos = elementos_nivel(h, plan, niveles - 1);
+    return 11 * (size_t) h * h + (niveles > 0 ? 7 : 1) * hijos;
+}
+
+PlanStrassen crear_plan_strassen(int n, int corte, int num_hilos, size_t tam_elem,
+                                 const OpcionesGemm* op) {
+    PlanStrassen plan;
+    if (corte < CORTE_STRASSEN_MINIMO) corte = CORTE_STRASSEN_MINIMO;
+
+    // N = s * 2^d: el relleno es menor que 2^d filas y columnas
+    int s = n, d = 0;
+    while (s > corte) {
+        s = (s + 1) / 2;
+        d++;
+    }
+    plan.n = n;
+    plan.N = s << d;
+    plan.corte = corte;
+    plan.num_hilos = num_hilos;
+    plan.tam_elem = tam_elem;
+    plan.elems_hoja = 0;
+    if (op->kernel == KERNEL_EMPAQUETADO) {
+        plan.elems_hoja = (bytes_paneles_empaquetado(corte, tam_elem) + tam_elem - 1) / tam_elem;
+    }
+
+    // Niveles en paralelo: los necesarios para 7^niveles >= hilos
+    plan.niveles = 0;
+    for (long tareas = 1; tareas < num_hilos && plan.niveles < d; tareas *= 7) {
+        plan.niveles++;
+    }
+
+    size_t elems = elementos_nivel(plan.N, &plan, plan.niveles);
+    if (plan.N > n) {
+        elems += 3 * (size_t) plan.N * plan.N;   // Copias de A, B y C con relleno
+    }
+    plan.bytes = (elems > 0 ? elems : 1) * tam_elem;
+    plan.arena = reservar_alineado(plan.bytes, &plan.mapeada);
+    if (!plan.arena) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    return plan;
+}
+
+void liberar_plan_strassen(PlanStrassen* plan) {
+    liberar_alineado(plan->arena, plan->bytes, plan->mapeada);
+    plan->arena = NULL;
+}
+
+static double segundos(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+#define TIPO int
+#define SUFIJO int
+#include "gemm_strassen_plantilla.h"
+
+#define TIPO double
+#define SUFIJO double
+#include "gemm_strassen_plantilla.h"
@@ -0,0 +1,277 @@
+/*
+ * Plantilla de Strassen-Winograd. Se incluye una vez por tipo desde
+ * gemm_strassen.c con TIPO y SUFIJO definidos (ver gemm_bloques_plantilla.h).
+ *
+ * Con S y T combinaciones de cuadrantes de A y B:
+ *   M1 = A11 B11   M2 = A12 B21   M3 = S4 B22   M4 = A22 T4
+ *   M5 = S1 T1     M6 = S2 T2     M7 = S3 T3
+ *   C11 = M1 + M2                 C12 = M1 + M6 + M5 + M3
+ *   C21 = M1 + M6 + M7 - M4       C22 = M1 + M6 + M7 + M5
+ * M2..M5 se calculan directamente en C11, C12, C21 y C22.
+ */
+
+#define UNIR_(a, b) a##_##b
+#define UNIR(a, b)  UNIR_(a, b)
+#define FN(nombre)  UNIR(nombre, SUFIJO)
+
+// Cuadrantes de A, B y C de un nivel
+typedef struct {
+    int h;
+    const TIPO* A[2][2];
+    const TIPO* B[2][2];
+    TIPO* C[2][2];
+    int lda, ldb, ldc;
+    TIPO* tmp[11];      // S1..S4, T1..T4, M1, M6, M7 (h x h, ld = h)
+} FN(NivelStrassen);
+
+// D = X1 +- X2 (+- X3 (+- X4)) elemento a elemento; signo 0 termina la lista
+static void FN(combinar)(int h, TIPO* D, int ldd,
+                         const TIPO* X1, int ld1,
+                         int s2, const TIPO* X2, int ld2,
+                         int s3, const TIPO* X3, int ld3,
+                         int s4, const TIPO* X4, int ld4) {
+    for (int i = 0; i < h; i++) {
+        TIPO* restrict d = D + (size_t) i * ldd;
+        const TIPO* restrict x1 = X1 + (size_t) i * ld1;
+        const TIPO* restrict x2 = X2 + (size_t) i * ld2;
+        for (int j = 0; j < h; j++) d[j] = x1[j] + s2 * x2[j];
+        if (s3) {
+            const TIPO* restrict x3 = X3 + (size_t) i * ld3;
+            for (int j = 0; j < h; j++) d[j] += s3 * x3[j];
+        }
+        if (s4) {
+            const TIPO* restrict x4 = X4 + (size_t) i * ld4;
+            for (int j = 0; j < h; j++) d[j] += s4 * x4[j];
+        }
+    }
+}
+
+static void FN(recursion_strassen)(int N, const TIPO* A, int lda, const TIPO* B, int ldb,
+                                   TIPO* C, int ldc, TIPO* arena, const PlanStrassen* plan,
+                                   int niveles, const OpcionesGemm* op);
+
+// Producto p (0..6 -> M1..M7) con sus operandos S/T calculados dentro de la tarea
+static void FN(producto_winograd)(int p, const FN(NivelStrassen)* v, TIPO* arena,
+                                  const PlanStrassen* plan, int niveles, const OpcionesGemm* op) {
+    int h = v->h;
+    TIPO* const* x = v->tmp;
+    switch (p) {
+        case 0:     // M1 = A11 B11
+            FN(recursion_strassen)(h, v->A[0][0], v->lda, v->B[0][0], v->ldb,
+                                   x[M1], h, arena, plan, niveles, op);
+            break;
+        case 1:     // M2 = A12 B21 -> C11
+            FN(recursion_strassen)(h, v->A[0][1], v->lda, v->B[1][0], v->ldb,
+                                   v->C[0][0], v->ldc, arena, plan, niveles, op);
+            break;
+        case 2:     // S4 = A12 - A21 - A22 + A11; M3 = S4 B22 -> C12
+            FN(combinar)(h, x[S4], h, v->A[0][1], v->lda, -1, v->A[1][0], v->lda,
+                         -1, v->A[1][1], v->lda, 1, v->A[0][0], v->lda);
+            FN(recursion_strassen)(h, x[S4], h, v->B[1][1], v->ldb,
+                                   v->C[0][1], v->ldc, arena, plan, niveles, op);
+            break;
+        case 3:     // T4 = B22 - B12 + B11 - B21; M4 = A22 T4 -> C21
+            FN(combinar)(h, x[T4], h, v->B[1][1], v->ldb, -1, v->B[0][1], v->ldb,
+                         1, v->B[0][0], v->ldb, -1, v->B[1][0], v->ldb);
+            FN(recursion_strassen)(h, v->A[1][1], v->lda, x[T4], h,
+                                   v->C[1][0], v->ldc, arena, plan, niveles, op);
+            break;
+        case 4:     // S1 = A21 + A22; T1 = B12 - B11; M5 = S1 T1 -> C22
+            FN(combinar)(h, x[S1], h, v->A[1][0], v->lda, 1, v->A[1][1], v->lda,
+                         0, NULL, 0, 0, NULL, 0);
+            FN(combinar)(h, x[T1], h, v->B[0][1], v->ldb, -1, v->B[0][0], v->ldb,
+                         0, NULL, 0, 0, NULL, 0);
+            FN(recursion_strassen)(h, x[S1], h, x[T1], h,
+                                   v->C[1][1], v->ldc, arena, plan, niveles, op);
+            break;
+        case 5:     // S2 = A21 + A22 - A11; T2 = B22 - B12 + B11; M6 = S2 T2
+            FN(combinar)(h, x[S2], h, v->A[1][0], v->lda, 1, v->A[1][1], v->lda,
+                         -1, v->A[0][0], v->lda, 0, NULL, 0);
+            FN(combinar)(h, x[T2], h, v->B[1][1], v->ldb, -1, v->B[0][1], v->ldb,
+                         1, v->B[0][0], v->ldb, 0, NULL, 0);
+            FN(recursion_strassen)(h, x[S2], h, x[T2], h, x[M6], h, arena, plan, niveles, op);
+            break;
+        default:    // S3 = A11 - A21; T3 = B22 - B12; M7 = S3 T3
+            FN(combinar)(h, x[S3], h, v->A[0][0], v->lda, -1, v->A[1][0], v->lda,
+                         0, NULL, 0, 0, NULL, 0);
+            FN(combinar)(h, x[T3], h, v->B[1][1], v->ldb, -1, v->B[0][1], v->ldb,
+                         0, NULL, 0, 0, NULL, 0);
+            FN(recursion_strassen)(h, x[S3], h, x[T3], h, x[M7], h, arena, plan, niveles, op);
+            break;
+    }
+}
+
+static void FN(recursion_strassen)(int N, const TIPO* A, int lda, const TIPO* B, int ldb,
+                                   TIPO* C, int ldc, TIPO* arena, const PlanStrassen* plan,
+                                   int niveles, const OpcionesGemm* op) {
+    if (N <= plan->corte) {
+        // Los paneles del kernel empaquetado están en la arena de la hoja
+        if (plan->elems_hoja > 0 && op->kernel == KERNEL_EMPAQUETADO)
+            FN(multiplicar_empaquetado_paneles)(N, N, N, A, lda, B, ldb, C, ldc, arena);
+        else
+            FN(multiplicar)(op, N, N, N, A, lda, B, ldb, C, ldc);
+        return;
+    }
+
+    int h = N / 2;
+    size_t hh = (size_t) h * h;
+    FN(NivelStrassen) v;
+    v.h = h;
+    v.lda = lda;
+    v.ldb = ldb;
+    v.ldc = ldc;
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {
+            v.A[i][j] = A + (size_t) i * h * lda + j * h;
+            v.B[i][j] = B + (size_t) i * h * ldb + j * h;
+            v.C[i][j] = C + (size_t) i * h * ldc + j * h;
+        }
+    }
+    for (int i = 0; i < 11; i++) {
+        v.tmp[i] = arena + i * hh;
+    }
+
+    // Con tareas cada producto recibe su propia parte de la arena; en serie
+    // los siete reutilizan la misma
+    TIPO* hijos = arena + 11 * hh;
+    size_t tam_hijo = elementos_nivel(h, plan, niveles - 1);
+    int paralelo = niveles > 0;
+    for (int p = 0; p < 7; p++) {
+        TIPO* propia = hijos + (paralelo ? p * tam_hijo : 0);
+        #pragma omp task if(paralelo) firstprivate(p, propia) shared(v)
+        FN(producto_winograd)(p, &v, propia, plan, niveles - 1, op);
+    }
+    #pragma omp taskwait
+
+    // U2 = M1 + M6, U3 = U2 + M7, U4 = U2 + M5 (M5 está en C22)
+    TIPO* x1 = v.tmp[M1];
+    TIPO* x6 = v.tmp[M6];
+    TIPO* x7 = v.tmp[M7];
+    for (int i = 0; i < h; i++) {
+        TIPO* restrict c11 = v.C[0][0] + (size_t) i * ldc;
+        TIPO* restrict c12 = v.C[0][1] + (size_t) i * ldc;
+        TIPO* restrict c21 = v.C[1][0] + (size_t) i * ldc;
+        TIPO* restrict c22 = v.C[1][1] + (size_t) i * ldc;
+        const TIPO* restrict m1 = x1 + (size_t) i * h;
+        const TIPO* restrict m6 = x6 + (size_t) i * h;
+        const TIPO* restrict m7 = x7 + (size_t) i * h;
+        for (int j = 0; j < h; j++) {
+            TIPO u2 = m1[j] + m6[j];
+            TIPO u3 = u2 + m7[j];
+            TIPO u4 = u2 + c22[j];
+            c11[j] += m1[j];
+            c12[j] += u4;
+            c21[j] = u3 - c21[j];
+            c22[j] += u3;
+        }
+    }
+}
+
+// Copia la matriz n x n de origen en un bloque N x N con relleno de ceros
+static void FN(copiar_con_relleno)(int n, int N, const TIPO* origen, int ld, TIPO* destino) {
+    for (int i = 0; i < N; i++) {
+        TIPO* d = destino + (size_t) i * N;
+        const TIPO* o = origen + (size_t) i * ld;
+        for (int j = 0; j < N; j++) {
+            d[j] = (i < n && j < n) ? o[j] : 0;
+        }
+    }
+}
+
+void FN(multiplicar_strassen)(const PlanStrassen* plan, const TIPO* A, int lda,
+                              const TIPO* B, int ldb, TIPO* C, int ldc,
+                              const OpcionesGemm* op) {
+    int n = plan->n, N = plan->N;
+    TIPO* arena = (TIPO*) plan->arena;
+    const TIPO* Ap = A;
+    const TIPO* Bp = B;
+    TIPO* Cp = C;
+    int la = lda, lb = ldb, lc = ldc;
+
+    if (N > n) {
+        size_t NN = (size_t) N * N;
+        FN(copiar_con_relleno)(n, N, A, lda, arena);
+        FN(copiar_con_relleno)(n, N, B, ldb, arena + NN);
+        Ap = arena;
+        Bp = arena + NN;
+        Cp = arena + 2 * NN;
+        la = lb = lc = N;
+        arena += 3 * NN;
+    }
+
+    // Un hilo recorre la recursión y el equipo ejecuta los productos
+    #pragma omp parallel num_threads(plan->num_hilos)
+    #pragma omp single
+    FN(recursion_strassen)(N, Ap, la, Bp, lb, Cp, lc, arena, plan, plan->niveles, op);
+
+    if (N > n) {
+        for (int i = 0; i < n; i++) {
+            TIPO* c = C + (size_t) i * ldc;
+            const TIPO* cp = Cp + (size_t) i * N;
+            for (int j = 0; j < n; j++) c[j] = cp[j];
+        }
+    }
+}
+
+int FN(calibrar_corte_strassen)(int n, int num_hilos, const OpcionesGemm* op) {
+    int corte = n, candidato = 0, victorias = 0;
+    for (int s = 64; s < n; s *= 2) {
+        int N = 2 * s;
+        size_t NN = (size_t) N * N;
+        int map;
+        TIPO* buf = (TIPO*) reservar_alineado(3 * NN * sizeof(TIPO), &map);
+        if (!buf) {
+            perror("Error al asignar memoria");
+            exit(EXIT_FAILURE);
+        }
+        TIPO* A = buf;
+        TIPO* B = buf + NN;
+        TIPO* C = buf + 2 * NN;
+        unsigned estado = 12345u;
+        for (size_t i = 0; i < 2 * NN; i++) {
+            buf[i] = (TIPO) (rand_r(&estado) % 10);
+        }
+
+        // Mejor de tres medidas de cada uno. El clásico en paralelo toma una
+        // franja contigua de filas por hilo.
+        PlanStrassen plan = crear_plan_strassen(N, s, num_hilos, sizeof(TIPO), op);
+        double clasico = 0.0, rapido = 0.0;
+        for (int rep = 0; rep < 3; rep++) {
+            double t0 = segundos();
+            #pragma omp parallel for num_threads(num_hilos) schedule(static)
+            for (int h = 0; h < num_hilos; h++) {
+                int inicio = (int) ((long) N * h / num_hilos);
+                int fin = (int) ((long) N * (h + 1) / num_hilos);
+                FN(multiplicar)(op, fin - inicio, N, N, A + (size_t) inicio * N, N, B, N,
+                                C + (size_t) inicio * N, N);
+            }
+            double t1 = segundos();
+            FN(multiplicar_strassen)(&plan, A, N, B, N, C, N, op);
+            double t2 = segundos();
+            if (rep == 0 || t1 - t0 < clasico) clasico = t1 - t0;
+            if (rep == 0 || t2 - t1 < rapido) rapido = t2 - t1;
+        }
+        liberar_plan_strassen(&plan);
+        liberar_alineado(buf, 3 * NN * sizeof(TIPO), map);
+
+        // El corte es el primer lado a partir del cual Strassen gana dos veces
+        // seguidas: una victoria aislada suele ser ruido de medida
+        if (rapido < clasico) {
+            if (candidato == 0) candidato = s;
+            if (++victorias == 2 || 2 * s >= n) {
+                corte = candidato;
+                break;
+            }
+        } else {
+            candidato = 0;
+            victorias = 0;
+        }
+    }
+    return corte;
+}
+
+#undef FN
+#undef UNIR
+#undef UNIR_
+#undef TIPO
+#undef SUFIJO
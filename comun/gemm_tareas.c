@@ -0,0 +1,10 @@
+#include "gemm.h"
+#include "matriz.h"
+
+#define TIPO int
+#define SUFIJO int
+#include "gemm_tareas_plantilla.h"
+
+#define TIPO double
+#define SUFIJO double
+#include "gemm_tareas_plantilla.h"
@@ -0,0 +1,75 @@
+/*
+ * Plantilla del motor recursivo con tareas OpenMP. Se incluye una vez por
+ * tipo desde gemm_tareas.c con TIPO y SUFIJO definidos (ver
+ * gemm_bloques_plantilla.h).
+ *
+ * La recursión es independiente de la caché: cada nivel reduce a la mitad
+ * las dimensiones grandes, así que en algún nivel los operandos caben en L1,
+ * L2 y L3 sin ajustar tamaños de baldosa por máquina.
+ */
+
+#define UNIR_(a, b) a##_##b
+#define UNIR(a, b)  UNIR_(a, b)
+#define FN(nombre)  UNIR(nombre, SUFIJO)
+
+// Punto de corte de n: la mitad redondeada a líneas de caché completas, para
+// que dos tareas no escriban la misma línea de C
+static int FN(mitad_columnas)(int n) {
+    int por_linea = (int) (MATRIZ_ALINEACION / sizeof(TIPO));
+    int mitad = (n / 2 + por_linea - 1) / por_linea * por_linea;
+    return mitad < n ? mitad : n / 2;
+}
+
+// C (+)= A * B; acumular = 0 sobrescribe C
+static void FN(recursion_tareas)(int m, int n, int k,
+                                 const TIPO* A, int lda, const TIPO* B, int ldb,
+                                 TIPO* C, int ldc, int acumular, int corte,
+                                 const TamBloques* t) {
+    if (m <= corte && n <= corte && k <= corte) {
+        if (acumular)
+            FN(acumular_bloques)(m, n, k, A, lda, B, ldb, C, ldc, t);
+        else
+            FN(multiplicar_bloques)(m, n, k, A, lda, B, ldb, C, ldc, t);
+        return;
+    }
+
+    // Sólo se parten las dimensiones que superan el corte
+    int m1 = m > corte ? m / 2 : m;
+    int n1 = n > corte ? FN(mitad_columnas)(n) : n;
+    int k1 = k > corte ? k / 2 : k;
+    int filas[2] = {m1, m - m1}, cols[2] = {n1, n - n1}, prof[2] = {k1, k - k1};
+
+    #pragma omp taskgroup
+    {
+        for (int a = 0; a < 2 && filas[a] > 0; a++) {
+            for (int b = 0; b < 2 && cols[b] > 0; b++) {
+                TIPO* Cab = C + (size_t) (a * m1) * ldc + b * n1;
+                for (int c = 0; c < 2 && prof[c] > 0; c++) {
+                    const TIPO* Aac = A + (size_t) (a * m1) * lda + c * k1;
+                    const TIPO* Bcb = B + (size_t) (c * k1) * ldb + b * n1;
+                    int acumula = acumular || c > 0;
+                    // Las mitades de K del mismo cuadrante se ejecutan en orden
+                    #pragma omp task depend(inout: Cab[0])
+                    FN(recursion_tareas)(filas[a], cols[b], prof[c], Aac, lda, Bcb, ldb,
+                                         Cab, ldc, acumula, corte, t);
+                }
+            }
+        }
+    }
+}
+
+void FN(multiplicar_tareas)(int m, int n, int k,
+                            const TIPO* A, int lda, const TIPO* B, int ldb,
+                            TIPO* C, int ldc, int corte, int num_hilos,
+                            const TamBloques* t) {
+    // Un hilo genera el árbol de tareas y el resto del equipo las ejecuta
+    #pragma omp parallel num_threads(num_hilos)
+    #pragma omp single
+    FN(recursion_tareas)(m, n, k, A, lda, B, ldb, C, ldc, 0, corte, t);
+}
+
+#undef FN
+#undef UNIR
+#undef UNIR_
+#undef TIPO
+#undef SUFIJO
@@ -0,0 +1,135 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "matriz.h"
+
+#define TAM_PAGINA       4096
+#define TAM_PAGINA_HUGE  (2UL * 1024 * 1024)
+
+// Función para calcular la dimensión principal con relleno
+int dimension_principal(int n, size_t tam_elem) {
+    int por_linea = (int) (MATRIZ_ALINEACION / tam_elem);
+    int ld = (n + por_linea - 1) / por_linea * por_linea;
+
+    // Un paso entre filas múltiplo de 4 KB hace que B[k][j], B[k+1][j], ...
+    // caigan en el mismo conjunto de la caché: se añade una línea extra
+    if (((size_t) ld * tam_elem) % TAM_PAGINA == 0) {
+        ld += por_linea;
+    }
+    return ld;
+}
+
+static int usar_paginas_grandes(void) {
+    const char* valor = getenv("HPC_HUGEPAGES");
+    return valor != NULL && strcmp(valor, "0") != 0;
+}
+
+// Función para reservar un buffer alineado (opcionalmente con páginas grandes)
+void* reservar_alineado(size_t bytes, int* mapeada) {
+    void* p = NULL;
+    *mapeada = 0;
+
+    if (usar_paginas_grandes()) {
+#ifdef MAP_HUGETLB
+        size_t redondeado = (bytes + TAM_PAGINA_HUGE - 1) & ~(TAM_PAGINA_HUGE - 1);
+        p = mmap(NULL, redondeado, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            *mapeada = 1;
+            return p;
+        }
+#endif
+        // Sin páginas reservadas en el sistema: páginas grandes transparentes
+        if (posix_memalign(&p, TAM_PAGINA_HUGE, bytes) != 0) {
+            return NULL;
+        }
+#ifdef MADV_HUGEPAGE
+        madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+        return p;
+    }
+
+    if (posix_memalign(&p, MATRIZ_ALINEACION, bytes) != 0) {
+        return NULL;
+    }
+    return p;
+}
+
+// Función para liberar un buffer de reservar_alineado
+void liberar_alineado(void* p, size_t bytes, int mapeada) {
+    if (p == NULL) return;
+    if (mapeada) {
+        size_t redondeado = (bytes + TAM_PAGINA_HUGE - 1) & ~(TAM_PAGINA_HUGE - 1);
+        munmap(p, redondeado);
+    } else {
+        free(p);
+    }
+}
+
+// Función para reservar memoria para una matriz cuadrada
+Matriz reservar_matriz(int n) {
+    Matriz m;
+    m.n = n;
+    m.ld = dimension_principal(n, sizeof(int));
+    m.bytes = (size_t) n * m.ld * sizeof(int);
+    m.datos = (int*) reservar_alineado(m.bytes, &m.mapeada);
+    if (!m.datos) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    return m;
+}
+
+// Función para liberar memoria de una matriz
+void liberar_matriz(Matriz* m) {
+    liberar_alineado(m->datos, m->bytes, m->mapeada);
+    m->datos = NULL;
+}
+
+// Función para inicializar la matriz con valores aleatorios
+void llenar_matriz(Matriz* m) {
+    for (int i = 0; i < m->n; i++) {
+        int* fila = FILA(*m, i);
+        for (int j = 0; j < m->n; j++) {
+            fila[j] = rand() % 10; // Números entre 0 y 9
+        }
+        // El relleno queda en cero para que los kernels vectoriales lo lean sin problema
+        for (int j = m->n; j < m->ld; j++) {
+            fila[j] = 0;
+        }
+    }
+}
+
+// Función para inicializar una franja de filas desde cualquier hilo
+void llenar_filas(Matriz* m, int i0, int i1, unsigned semilla) {
+    for (int i = i0; i < i1; i++) {
+        unsigned estado = semilla ^ (2654435761u * (unsigned) (i + 1));
+        int* fila = FILA(*m, i);
+        for (int j = 0; j < m->n; j++) {
+            fila[j] = rand_r(&estado) % 10;
+        }
+        for (int j = m->n; j < m->ld; j++) {
+            fila[j] = 0;
+        }
+    }
+}
+
+// Función para copiar una franja de filas entre matrices del mismo tamaño
+void copiar_filas(Matriz* destino, const Matriz* origen, int i0, int i1) {
+    for (int i = i0; i < i1; i++) {
+        memcpy(FILA(*destino, i), FILA(*origen, i), (size_t) origen->ld * sizeof(int));
+    }
+}
+
+// Función para imprimir una matriz
+void imprimir_matriz(const Matriz* m) {
+    for (int i = 0; i < m->n; i++) {
+        for (int j = 0; j < m->n; j++) {
+            printf("%d\t", ELEM(*m, i, j));
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef MATRIZ_H_
+#define MATRIZ_H_
+
+#include <stddef.h>
+
+// Alineación de los buffers: una línea de caché
+#define MATRIZ_ALINEACION 64
+
+/*
+ * Matriz cuadrada n x n almacenada por filas en un único buffer contiguo.
+ * Cada fila ocupa `ld` elementos (ld >= n): el relleno deja cada fila
+ * alineada a 64 bytes y evita que el paso entre filas sea múltiplo de 4 KB
+ * (aliasing de 4K en n = 1024, 2048, 4096, ...).
+ */
+typedef struct {
+    int n;          // Dimensión lógica
+    int ld;         // Dimensión principal (elementos por fila, con relleno)
+    int* datos;     // Buffer contiguo alineado a MATRIZ_ALINEACION
+    size_t bytes;   // Bytes reservados
+    int mapeada;    // 1 si el buffer viene de mmap con páginas grandes
+} Matriz;
+
+// Acceso al elemento (i, j) y a la fila i
+#define ELEM(M, i, j) ((M).datos[(size_t)(i) * (M).ld + (j)])
+#define FILA(M, i)    ((M).datos + (size_t)(i) * (M).ld)
+
+// Dimensión principal con relleno para filas de n elementos de tam_elem bytes
+int dimension_principal(int n, size_t tam_elem);
+
+// Reserva alineada a 64 bytes. Si la variable de entorno HPC_HUGEPAGES=1
+// está definida intenta usar páginas grandes (MAP_HUGETLB y, si no hay
+// páginas reservadas, madvise(MADV_HUGEPAGE)). *mapeada indica cómo liberar.
+void* reservar_alineado(size_t bytes, int* mapeada);
+void liberar_alineado(void* p, size_t bytes, int mapeada);
+
+Matriz reservar_matriz(int n);
+void liberar_matriz(Matriz* m);
+void llenar_matriz(Matriz* m);
+
+// Llena las filas [i0, i1) con valores 0..9 reproducibles (rand_r con una
+// semilla por fila), de modo que varios hilos pueden llenar franjas a la vez
+void llenar_filas(Matriz* m, int i0, int i1, unsigned semilla);
+
+// Copia las filas [i0, i1) de origen en destino (misma n)
+void copiar_filas(Matriz* destino, const Matriz* origen, int i0, int i1);
+
+void imprimir_matriz(const Matriz* m);
+
+#endif /* MATRIZ_H_ */
@@ -0,0 +1,43 @@
+#ifndef MICRONUCLEOS_H_
+#define MICRONUCLEOS_H_
+
+/*
+ * Micronúcleos del motor empaquetado: calculan C[mr x nr] += Ap * Bp, donde
+ * Ap es una tira de A empaquetada (kc columnas de mr elementos consecutivos)
+ * y Bp una tira de B empaquetada (kc filas de nr elementos consecutivos).
+ * C es un bloque de la matriz de salida con dimensión principal ldc.
+ */
+
+typedef struct {
+    int mr, nr;
+    void (*fn)(int kc, const int* Ap, const int* Bp, int* C, int ldc);
+    const char* nombre;
+} MicroInt;
+
+typedef struct {
+    int mr, nr;
+    void (*fn)(int kc, const float* Ap, const float* Bp, float* C, int ldc);
+    const char* nombre;
+} MicroFloat;
+
+typedef struct {
+    int mr, nr;
+    void (*fn)(int kc, const double* Ap, const double* Bp, double* C, int ldc);
+    const char* nombre;
+} MicroDouble;
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MICRONUCLEOS_X86 1
+
+// AVX2 + FMA: 6 filas x 2 registros de 256 bits
+extern const MicroInt micro_int_avx2;
+extern const MicroFloat micro_float_avx2;
+extern const MicroDouble micro_double_avx2;
+
+// AVX-512: 8 filas x 3 registros de 512 bits
+extern const MicroInt micro_int_avx512;
+extern const MicroFloat micro_float_avx512;
+extern const MicroDouble micro_double_avx512;
+#endif
+
+#endif /* MICRONUCLEOS_H_ */
@@ -0,0 +1,81 @@
+/*
+ * Micronúcleos con intrínsecos AVX2/AVX-512. Cada función se compila con su
+ * propio atributo target, así que el archivo no necesita -mavx2 ni
+ * -mavx512f: la elección en tiempo de ejecución la hace detectar_simd().
+ *
+ * Los acumuladores c[MR][NV] se desenrollan por completo y viven en
+ * registros durante todo el bucle en kc: MR*NV acumuladores + NV registros
+ * de B + 1 de A (15 de 16 en AVX2, 28 de 32 en AVX-512).
+ */
+#include "micronucleos.h"
+
+#ifdef MICRONUCLEOS_X86
+
+#include <immintrin.h>
+
+#define ATRIB_AVX2   __attribute__((target("avx2,fma")))
+#define ATRIB_AVX512 __attribute__((target("avx512f")))
+
+#define MICRO_SIMD(nombre, T, V, MR, NV, W, CARGAR, GUARDAR, DIFUNDIR, FMA, ATRIB) \
+    ATRIB static void nombre(int kc, const T* restrict Ap, const T* restrict Bp,   \
+                             T* restrict C, int ldc) {                             \
+        V c[MR][NV];                                                               \
+        _Pragma("GCC unroll 8")                                                    \
+        for (int r = 0; r < MR; r++)                                               \
+            _Pragma("GCC unroll 3")                                                \
+            for (int v = 0; v < NV; v++)                                           \
+                c[r][v] = CARGAR(C + (size_t) r * ldc + v * W);                    \
+        for (int p = 0; p < kc; p++) {                                             \
+            V b[NV];                                                               \
+            _Pragma("GCC unroll 3")                                                \
+            for (int v = 0; v < NV; v++)                                           \
+                b[v] = CARGAR(Bp + (size_t) p * (NV * W) + v * W);                 \
+            _Pragma("GCC unroll 8")                                                \
+            for (int r = 0; r < MR; r++) {                                         \
+                V a = DIFUNDIR(Ap[(size_t) p * MR + r]);                           \
+                _Pragma("GCC unroll 3")                                            \
+                for (int v = 0; v < NV; v++)                                       \
+                    c[r][v] = FMA(a, b[v], c[r][v]);                               \
+            }                                                                      \
+        }                                                                          \
+        _Pragma("GCC unroll 8")                                                    \
+        for (int r = 0; r < MR; r++)                                               \
+            _Pragma("GCC unroll 3")                                                \
+            for (int v = 0; v < NV; v++)                                           \
+                GUARDAR(C + (size_t) r * ldc + v * W, c[r][v]);                    \
+    }
+
+// double
+MICRO_SIMD(micro_double_avx2_6x8, double, __m256d, 6, 2, 4,
+           _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd, _mm256_fmadd_pd, ATRIB_AVX2)
+MICRO_SIMD(micro_double_avx512_8x24, double, __m512d, 8, 3, 8,
+           _mm512_loadu_pd, _mm512_storeu_pd, _mm512_set1_pd, _mm512_fmadd_pd, ATRIB_AVX512)
+
+// float
+MICRO_SIMD(micro_float_avx2_6x16, float, __m256, 6, 2, 8,
+           _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, _mm256_fmadd_ps, ATRIB_AVX2)
+MICRO_SIMD(micro_float_avx512_8x48, float, __m512, 8, 3, 16,
+           _mm512_loadu_ps, _mm512_storeu_ps, _mm512_set1_ps, _mm512_fmadd_ps, ATRIB_AVX512)
+
+// int: sin FMA entero, multiplicación de 32 bits (mullo) más suma
+#define CARGAR_I256(p)       _mm256_loadu_si256((const __m256i*) (p))
+#define GUARDAR_I256(p, v)   _mm256_storeu_si256((__m256i*) (p), (v))
+#define FMA_I256(a, b, c)    _mm256_add_epi32((c), _mm256_mullo_epi32((a), (b)))
+#define CARGAR_I512(p)       _mm512_loadu_si512((const void*) (p))
+#define GUARDAR_I512(p, v)   _mm512_storeu_si512((void*) (p), (v))
+#define FMA_I512(a, b, c)    _mm512_add_epi32((c), _mm512_mullo_epi32((a), (b)))
+
+MICRO_SIMD(micro_int_avx2_6x16, int, __m256i, 6, 2, 8,
+           CARGAR_I256, GUARDAR_I256, _mm256_set1_epi32, FMA_I256, ATRIB_AVX2)
+MICRO_SIMD(micro_int_avx512_8x48, int, __m512i, 8, 3, 16,
+           CARGAR_I512, GUARDAR_I512, _mm512_set1_epi32, FMA_I512, ATRIB_AVX512)
+
+const MicroInt micro_int_avx2 = {6, 16, micro_int_avx2_6x16, "avx2 6x16"};
+const MicroFloat micro_float_avx2 = {6, 16, micro_float_avx2_6x16, "avx2 6x16"};
+const MicroDouble micro_double_avx2 = {6, 8, micro_double_avx2_6x8, "avx2 6x8"};
+
+const MicroInt micro_int_avx512 = {8, 48, micro_int_avx512_8x48, "avx512 8x48"};
+const MicroFloat micro_float_avx512 = {8, 48, micro_float_avx512_8x48, "avx512 8x48"};
+const MicroDouble micro_double_avx512 = {8, 24, micro_double_avx512_8x24, "avx512 8x24"};
+
+#endif /* MICRONUCLEOS_X86 */
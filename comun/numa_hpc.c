@@ -0,0 +1,174 @@
+#define _GNU_SOURCE
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "numa_hpc.h"
+
+#define RUTA_NODOS "/sys/devices/system/node"
+#define MPOL_INTERCALADO 3      // MPOL_INTERLEAVE de <numaif.h>
+#define TAM_PAGINA 4096
+
+int parsear_modo_numa(const char* texto, ModoNuma* modo) {
+    static const ModoNuma todos[] = {NUMA_NO, NUMA_PRIMER_TOQUE, NUMA_INTERCALADO, NUMA_REPLICADO};
+    for (size_t i = 0; i < sizeof(todos) / sizeof(todos[0]); i++) {
+        if (strcmp(texto, nombre_modo_numa(todos[i])) == 0) {
+            *modo = todos[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char* nombre_modo_numa(ModoNuma modo) {
+    switch (modo) {
+        case NUMA_NO: return "no";
+        case NUMA_PRIMER_TOQUE: return "primer-toque";
+        case NUMA_INTERCALADO: return "intercalado";
+        case NUMA_REPLICADO: return "replicado";
+    }
+    return "desconocido";
+}
+
+// Función para leer una lista de CPUs como "0-7,16-23" y quedarse con las permitidas
+static int leer_cpulist(const char* ruta, const cpu_set_t* permitidas, int* cpus) {
+    FILE* fp = fopen(ruta, "r");
+    if (!fp) return -1;
+
+    int total = 0, a, b;
+    char sep;
+    while (fscanf(fp, "%d", &a) == 1) {
+        b = a;
+        if (fscanf(fp, "%c", &sep) == 1 && sep == '-') {
+            if (fscanf(fp, "%d", &b) != 1) break;
+            if (fscanf(fp, "%c", &sep) != 1) sep = '\n';
+        }
+        for (int c = a; c <= b && c < CPU_SETSIZE; c++) {
+            if (CPU_ISSET(c, permitidas)) cpus[total++] = c;
+        }
+        if (sep != ',') break;
+    }
+    fclose(fp);
+    return total;
+}
+
+void detectar_topologia(TopologiaNuma* topo) {
+    cpu_set_t permitidas;
+    char ruta[256];
+
+    memset(topo, 0, sizeof(*topo));
+    if (sched_getaffinity(0, sizeof(permitidas), &permitidas) != 0) {
+        CPU_ZERO(&permitidas);
+        for (int c = 0; c < CPU_SETSIZE; c++) CPU_SET(c, &permitidas);
+    }
+
+    for (int nodo = 0; nodo < 1024 && topo->num_nodos < NUMA_MAX_NODOS; nodo++) {
+        snprintf(ruta, sizeof(ruta), RUTA_NODOS "/node%d/cpulist", nodo);
+        if (access(ruta, R_OK) != 0) continue;
+
+        int* cpus = (int*) malloc(CPU_SETSIZE * sizeof(int));
+        if (!cpus) {
+            perror("Error al asignar memoria");
+            exit(EXIT_FAILURE);
+        }
+        int total = leer_cpulist(ruta, &permitidas, cpus);
+        if (total <= 0) {
+            // Nodo sin CPUs permitidas (sólo memoria o fuera del cpuset)
+            free(cpus);
+            continue;
+        }
+        topo->ids[topo->num_nodos] = nodo;
+        topo->num_cpus[topo->num_nodos] = total;
+        topo->cpus[topo->num_nodos] = cpus;
+        topo->num_nodos++;
+    }
+
+    // Sin sysfs de nodos: un único nodo con todas las CPUs permitidas
+    if (topo->num_nodos == 0) {
+        int* cpus = (int*) malloc(CPU_SETSIZE * sizeof(int));
+        if (!cpus) {
+            perror("Error al asignar memoria");
+            exit(EXIT_FAILURE);
+        }
+        int total = 0;
+        for (int c = 0; c < CPU_SETSIZE; c++) {
+            if (CPU_ISSET(c, &permitidas)) cpus[total++] = c;
+        }
+        topo->num_nodos = 1;
+        topo->ids[0] = 0;
+        topo->num_cpus[0] = total;
+        topo->cpus[0] = cpus;
+    }
+}
+
+void liberar_topologia(TopologiaNuma* topo) {
+    for (int i = 0; i < topo->num_nodos; i++) {
+        free(topo->cpus[i]);
+        topo->cpus[i] = NULL;
+    }
+    topo->num_nodos = 0;
+}
+
+int nodo_de_hilo(const TopologiaNuma* topo, int h, int num_hilos) {
+    return (int) ((long) h * topo->num_nodos / num_hilos);
+}
+
+int fijar_hilo_nodo(const TopologiaNuma* topo, int h, int num_hilos) {
+    int nodo = nodo_de_hilo(topo, h, num_hilos);
+
+    // Primer hilo asignado al mismo nodo: posición de h dentro del nodo
+    int primero = (int) (((long) nodo * num_hilos + topo->num_nodos - 1) / topo->num_nodos);
+    int cpu = topo->cpus[nodo][(h - primero) % topo->num_cpus[nodo]];
+
+    cpu_set_t uno;
+    CPU_ZERO(&uno);
+    CPU_SET(cpu, &uno);
+    if (sched_setaffinity(0, sizeof(uno), &uno) != 0) return -1;
+    return cpu;
+}
+
+Matriz reservar_matriz_intercalada(int n, const TopologiaNuma* topo) {
+    Matriz m;
+    void* p = NULL;
+    m.n = n;
+    m.ld = dimension_principal(n, sizeof(int));
+    m.bytes = (size_t) n * m.ld * sizeof(int);
+    m.mapeada = 0;
+    if (posix_memalign(&p, TAM_PAGINA, m.bytes) != 0) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    m.datos = (int*) p;
+
+    // La política se aplica antes del primer toque: las páginas se reparten
+    // por turnos entre los nodos
+    if (topo->num_nodos > 1) {
+        unsigned long mascara[NUMA_MAX_NODOS / (8 * sizeof(unsigned long)) + 1] = {0};
+        int max_id = 0;
+        for (int i = 0; i < topo->num_nodos; i++) {
+            int id = topo->ids[i];
+            mascara[id / (8 * sizeof(unsigned long))] |= 1UL << (id % (8 * sizeof(unsigned long)));
+            if (id > max_id) max_id = id;
+        }
+        size_t largo = (m.bytes + TAM_PAGINA - 1) / TAM_PAGINA * TAM_PAGINA;
+        if (syscall(SYS_mbind, p, largo, MPOL_INTERCALADO, mascara, max_id + 2, 0) != 0) {
+            perror("Aviso: mbind no pudo intercalar la matriz");
+        }
+    }
+    return m;
+}
+
+void describir_reparto(const TopologiaNuma* topo, int num_hilos, char* buf, size_t tam) {
+    size_t usado = 0;
+    buf[0] = '\0';
+    for (int nodo = 0; nodo < topo->num_nodos && usado < tam; nodo++) {
+        int hilos = 0;
+        for (int h = 0; h < num_hilos; h++) {
+            if (nodo_de_hilo(topo, h, num_hilos) == nodo) hilos++;
+        }
+        usado += snprintf(buf + usado, tam - usado, "%s%d", nodo ? "/" : "", hilos);
+    }
+}
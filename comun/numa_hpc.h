@@ -0,0 +1,52 @@
+#ifndef NUMA_HPC_H_
+#define NUMA_HPC_H_
+
+#include <stddef.h>
+
+#include "matriz.h"
+
+#define NUMA_MAX_NODOS 64
+
+/*
+ * Ubicación NUMA para los programas de memoria compartida. La topología se
+ * lee de /sys/devices/system/node (sin depender de libnuma), los hilos se
+ * anclan con sched_setaffinity y el intercalado de páginas usa mbind.
+ *
+ * Los hilos se asignan a nodos en bloques contiguos (hilo h -> nodo
+ * h * nodos / hilos), igual que las franjas de filas, para que cada nodo
+ * inicialice (primer toque) y calcule las mismas filas de A y C.
+ */
+typedef enum {
+    NUMA_NO,            // Sin ubicación: el hilo principal toca todo
+    NUMA_PRIMER_TOQUE,  // Cada hilo anclado inicializa sus filas de A, B y C
+    NUMA_INTERCALADO,   // Igual, pero B se intercala entre todos los nodos
+    NUMA_REPLICADO      // Igual, y cada nodo trabaja con su propia copia de B
+} ModoNuma;
+
+typedef struct {
+    int num_nodos;
+    int ids[NUMA_MAX_NODOS];         // Identificador del nodo en el sistema
+    int num_cpus[NUMA_MAX_NODOS];    // CPUs permitidas por nodo
+    int* cpus[NUMA_MAX_NODOS];
+} TopologiaNuma;
+
+int parsear_modo_numa(const char* texto, ModoNuma* modo);
+const char* nombre_modo_numa(ModoNuma modo);
+
+// Topología restringida a las CPUs permitidas para el proceso
+void detectar_topologia(TopologiaNuma* topo);
+void liberar_topologia(TopologiaNuma* topo);
+
+// Nodo (índice en topo) que corresponde al hilo h de num_hilos
+int nodo_de_hilo(const TopologiaNuma* topo, int h, int num_hilos);
+
+// Ancla el hilo que llama a una CPU del nodo de h. Devuelve la CPU o -1.
+int fijar_hilo_nodo(const TopologiaNuma* topo, int h, int num_hilos);
+
+// Matriz cuyas páginas se intercalan entre todos los nodos de topo
+Matriz reservar_matriz_intercalada(int n, const TopologiaNuma* topo);
+
+// Hilos por nodo, p. ej. "8/8" (sin comas, para usarlo en un CSV)
+void describir_reparto(const TopologiaNuma* topo, int num_hilos, char* buf, size_t tam);
+
+#endif /* NUMA_HPC_H_ */
@@ -0,0 +1,148 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pool_hilos.h"
+
+typedef struct {
+    PoolHilos* pool;
+    int id;
+} ArgTrabajador;
+
+struct PoolHilos {
+    int num_hilos;
+    int fijar;
+    pthread_t* hilos;
+    ArgTrabajador* args_trabajador;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t hay_trabajo;     // Señal a los trabajadores: nueva generación
+    pthread_cond_t terminado;       // Señal al hilo principal: pendientes == 0
+
+    unsigned long generacion;       // Se incrementa con cada ejecutar_pool
+    int pendientes;                 // Trabajadores que aún no terminan
+    int salir;
+
+    TareaPool tarea;
+    char* args;
+    size_t tam_arg;
+};
+
+int fijar_hilo_actual(int indice) {
+    cpu_set_t permitidas, uno;
+    if (sched_getaffinity(0, sizeof(permitidas), &permitidas) != 0) return -1;
+
+    int total = CPU_COUNT(&permitidas);
+    if (total == 0) return -1;
+    int objetivo = indice % total;
+
+    for (int cpu = 0, visto = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &permitidas)) continue;
+        if (visto++ == objetivo) {
+            CPU_ZERO(&uno);
+            CPU_SET(cpu, &uno);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(uno), &uno) != 0) return -1;
+            return cpu;
+        }
+    }
+    return -1;
+}
+
+static void* bucle_trabajador(void* arg) {
+    ArgTrabajador* yo = (ArgTrabajador*) arg;
+    PoolHilos* pool = yo->pool;
+    unsigned long vista = 0;
+
+    if (pool->fijar) {
+        fijar_hilo_actual(yo->id);
+    }
+
+    for (;;) {
+        pthread_mutex_lock(&pool->mutex);
+        while (pool->generacion == vista && !pool->salir) {
+            pthread_cond_wait(&pool->hay_trabajo, &pool->mutex);
+        }
+        if (pool->salir) {
+            pthread_mutex_unlock(&pool->mutex);
+            break;
+        }
+        vista = pool->generacion;
+        TareaPool tarea = pool->tarea;
+        void* mi_arg = pool->args + (size_t) yo->id * pool->tam_arg;
+        pthread_mutex_unlock(&pool->mutex);
+
+        tarea(yo->id, mi_arg);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->pendientes == 0) {
+            pthread_cond_signal(&pool->terminado);
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+    return NULL;
+}
+
+PoolHilos* crear_pool(int num_hilos, int fijar) {
+    PoolHilos* pool = (PoolHilos*) calloc(1, sizeof(PoolHilos));
+    if (!pool) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    pool->num_hilos = num_hilos;
+    pool->fijar = fijar;
+    pool->hilos = (pthread_t*) malloc(num_hilos * sizeof(pthread_t));
+    pool->args_trabajador = (ArgTrabajador*) malloc(num_hilos * sizeof(ArgTrabajador));
+    if (!pool->hilos || !pool->args_trabajador) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->hay_trabajo, NULL);
+    pthread_cond_init(&pool->terminado, NULL);
+
+    for (int i = 0; i < num_hilos; i++) {
+        pool->args_trabajador[i] = (ArgTrabajador) {pool, i};
+        if (pthread_create(&pool->hilos[i], NULL, bucle_trabajador, &pool->args_trabajador[i]) != 0) {
+            perror("Error al crear hilo");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return pool;
+}
+
+void ejecutar_pool(PoolHilos* pool, TareaPool tarea, void* args, size_t tam_arg) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->tarea = tarea;
+    pool->args = (char*) args;
+    pool->tam_arg = tam_arg;
+    pool->pendientes = pool->num_hilos;
+    pool->generacion++;
+    pthread_cond_broadcast(&pool->hay_trabajo);
+    while (pool->pendientes > 0) {
+        pthread_cond_wait(&pool->terminado, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+int hilos_pool(const PoolHilos* pool) {
+    return pool->num_hilos;
+}
+
+void destruir_pool(PoolHilos* pool) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->salir = 1;
+    pthread_cond_broadcast(&pool->hay_trabajo);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 0; i < pool->num_hilos; i++) {
+        pthread_join(pool->hilos[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->hay_trabajo);
+    pthread_cond_destroy(&pool->terminado);
+    free(pool->hilos);
+    free(pool->args_trabajador);
+    free(pool);
+}
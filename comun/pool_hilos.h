@@ -0,0 +1,33 @@
+#ifndef POOL_HILOS_H_
+#define POOL_HILOS_H_
+
+#include <stddef.h>
+
+/*
+ * Pool de hilos persistente: los hilos se crean una sola vez y esperan en
+ * una variable de condición. Cada llamada a ejecutar_pool despierta a todos
+ * los trabajadores con una tarea y vuelve cuando todos terminaron, de modo
+ * que una iteración cuesta el cálculo más una sola barrera.
+ */
+typedef struct PoolHilos PoolHilos;
+
+// Tarea de un trabajador: id en [0, num_hilos) y su argumento
+typedef void (*TareaPool)(int id, void* arg);
+
+// Crea num_hilos trabajadores. Si fijar != 0, el trabajador i queda anclado
+// a la i-ésima CPU permitida para el proceso (sched_getaffinity).
+PoolHilos* crear_pool(int num_hilos, int fijar);
+
+// Ejecuta tarea(i, args + i * tam_arg) en cada trabajador i y espera a todos
+void ejecutar_pool(PoolHilos* pool, TareaPool tarea, void* args, size_t tam_arg);
+
+int hilos_pool(const PoolHilos* pool);
+
+// Termina y une a los trabajadores
+void destruir_pool(PoolHilos* pool);
+
+// Ancla el hilo que llama a la CPU permitida número `indice` (módulo el total).
+// Devuelve la CPU usada o -1 si no se pudo.
+int fijar_hilo_actual(int indice);
+
+#endif /* POOL_HILOS_H_ */
@@ -0,0 +1,184 @@
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "robo_trabajo.h"
+
+#define LINEA_CACHE 64
+
+/*
+ * Cola de Chase-Lev de capacidad fija. El dueño empuja y saca por `fondo`;
+ * los ladrones sacan por `cima` con compare-and-swap. Cima y fondo van en
+ * líneas de caché distintas para que los robos no invaliden al dueño.
+ */
+typedef struct {
+    _Alignas(LINEA_CACHE) atomic_long cima;
+    _Alignas(LINEA_CACHE) atomic_long fondo;
+    _Alignas(LINEA_CACHE) Baldosa* buffer;
+    long capacidad;
+} ColaRobo;
+
+struct PlanificadorRobo {
+    int num_hilos;
+    ColaRobo* colas;
+    Baldosa* baldosas;      // Memoria de todos los buffers
+    long capacidad_total;
+    unsigned* semillas;     // Estado del generador de víctimas por hilo
+};
+
+// Resultado de un intento de robo
+enum { ROBO_VACIA, ROBO_ABORTADO, ROBO_EXITO };
+
+static void empujar(ColaRobo* q, Baldosa b) {
+    long f = atomic_load_explicit(&q->fondo, memory_order_relaxed);
+    q->buffer[f] = b;
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&q->fondo, f + 1, memory_order_relaxed);
+}
+
+static int sacar(ColaRobo* q, Baldosa* b) {
+    long f = atomic_load_explicit(&q->fondo, memory_order_relaxed) - 1;
+    atomic_store_explicit(&q->fondo, f, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long c = atomic_load_explicit(&q->cima, memory_order_relaxed);
+
+    if (c > f) {
+        // Cola vacía
+        atomic_store_explicit(&q->fondo, f + 1, memory_order_relaxed);
+        return 0;
+    }
+    *b = q->buffer[f];
+    if (c == f) {
+        // Último elemento: se compite con los ladrones por él
+        int gano = atomic_compare_exchange_strong_explicit(
+            &q->cima, &c, c + 1, memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&q->fondo, f + 1, memory_order_relaxed);
+        return gano;
+    }
+    return 1;
+}
+
+static int robar(ColaRobo* q, Baldosa* b) {
+    long c = atomic_load_explicit(&q->cima, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long f = atomic_load_explicit(&q->fondo, memory_order_acquire);
+
+    if (c >= f) return ROBO_VACIA;
+    *b = q->buffer[c];
+    if (!atomic_compare_exchange_strong_explicit(
+            &q->cima, &c, c + 1, memory_order_seq_cst, memory_order_relaxed)) {
+        return ROBO_ABORTADO;
+    }
+    return ROBO_EXITO;
+}
+
+PlanificadorRobo* crear_planificador(int num_hilos) {
+    PlanificadorRobo* plan = (PlanificadorRobo*) calloc(1, sizeof(PlanificadorRobo));
+    if (!plan) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    plan->num_hilos = num_hilos;
+    plan->colas = (ColaRobo*) aligned_alloc(LINEA_CACHE, num_hilos * sizeof(ColaRobo));
+    plan->semillas = (unsigned*) malloc(num_hilos * sizeof(unsigned));
+    if (!plan->colas || !plan->semillas) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < num_hilos; i++) {
+        atomic_init(&plan->colas[i].cima, 0);
+        atomic_init(&plan->colas[i].fondo, 0);
+        plan->colas[i].buffer = NULL;
+        plan->colas[i].capacidad = 0;
+        plan->semillas[i] = 2654435761u * (unsigned) (i + 1);
+    }
+    return plan;
+}
+
+void destruir_planificador(PlanificadorRobo* plan) {
+    free(plan->baldosas);
+    free(plan->colas);
+    free(plan->semillas);
+    free(plan);
+}
+
+void repartir_baldosas(PlanificadorRobo* plan, int filas, int cols, int alto, int ancho) {
+    long por_fila = (cols + ancho - 1) / ancho;
+    long total = (long) ((filas + alto - 1) / alto) * por_fila;
+
+    // Cada cola puede recibir como máximo su tramo: total / hilos redondeado
+    long tramo_max = (total + plan->num_hilos - 1) / plan->num_hilos;
+    if (tramo_max * plan->num_hilos > plan->capacidad_total) {
+        free(plan->baldosas);
+        plan->capacidad_total = tramo_max * plan->num_hilos;
+        plan->baldosas = (Baldosa*) malloc(plan->capacidad_total * sizeof(Baldosa));
+        if (!plan->baldosas) {
+            perror("Error al asignar memoria");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    long siguiente = 0;
+    for (int h = 0; h < plan->num_hilos; h++) {
+        ColaRobo* q = &plan->colas[h];
+        q->buffer = plan->baldosas + (long) h * tramo_max;
+        q->capacidad = tramo_max;
+        atomic_store_explicit(&q->cima, 0, memory_order_relaxed);
+        atomic_store_explicit(&q->fondo, 0, memory_order_relaxed);
+
+        // Tramo contiguo (en orden fila-mayor de baldosas) para conservar localidad
+        long fin = total * (h + 1) / plan->num_hilos;
+        for (; siguiente < fin; siguiente++) {
+            int bi = (int) (siguiente / por_fila), bj = (int) (siguiente % por_fila);
+            Baldosa b;
+            b.i0 = bi * alto;
+            b.i1 = b.i0 + alto < filas ? b.i0 + alto : filas;
+            b.j0 = bj * ancho;
+            b.j1 = b.j0 + ancho < cols ? b.j0 + ancho : cols;
+            empujar(q, b);
+        }
+    }
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+int siguiente_baldosa(PlanificadorRobo* plan, int id, Baldosa* b, long* robos) {
+    if (sacar(&plan->colas[id], b)) return 1;
+    if (plan->num_hilos == 1) return 0;
+
+    unsigned* semilla = &plan->semillas[id];
+    for (;;) {
+        int abortados = 0;
+        // Recorre a todas las víctimas empezando en una aleatoria
+        *semilla ^= *semilla << 13;
+        *semilla ^= *semilla >> 17;
+        *semilla ^= *semilla << 5;
+        int inicio = (int) (*semilla % (unsigned) plan->num_hilos);
+        for (int k = 0; k < plan->num_hilos; k++) {
+            int victima = (inicio + k) % plan->num_hilos;
+            if (victima == id) continue;
+            int r = robar(&plan->colas[victima], b);
+            if (r == ROBO_EXITO) {
+                (*robos)++;
+                return 1;
+            }
+            if (r == ROBO_ABORTADO) abortados++;
+        }
+        // Sin trabajo nuevo posible: si nadie compitió, todas las colas están vacías
+        if (abortados == 0) return 0;
+    }
+}
+
+void baldosa_defecto(int n, int num_hilos, int* alto, int* ancho) {
+    // Unas 4 baldosas de filas por hilo, hasta 64 filas y 256 columnas
+    int a = n / (4 * num_hilos);
+    *alto = a < 1 ? 1 : (a > 64 ? 64 : a);
+    *ancho = n <= 512 ? n : 256;
+}
+
+int parsear_baldosa(const char* texto, int* alto, int* ancho) {
+    int a, c;
+    if (sscanf(texto, "%dx%d", &a, &c) != 2 || a <= 0 || c <= 0) return -1;
+    *alto = a;
+    *ancho = c;
+    return 0;
+}
@@ -0,0 +1,37 @@
+#ifndef ROBO_TRABAJO_H_
+#define ROBO_TRABAJO_H_
+
+/*
+ * Planificador dinámico por robo de trabajo. C se divide en baldosas 2D; cada
+ * hilo recibe un tramo contiguo de baldosas en su propia cola de Chase-Lev,
+ * las consume por el fondo y, cuando se vacía, roba por la cima de las colas
+ * de otros hilos con un CAS (sin candados). Un núcleo lento o desplazado por
+ * el sistema pierde su cola de trabajo a favor de los demás.
+ */
+
+// Baldosa de C: filas [i0, i1) x columnas [j0, j1)
+typedef struct {
+    int i0, i1, j0, j1;
+} Baldosa;
+
+typedef struct PlanificadorRobo PlanificadorRobo;
+
+PlanificadorRobo* crear_planificador(int num_hilos);
+void destruir_planificador(PlanificadorRobo* plan);
+
+// Divide una matriz filas x cols en baldosas alto x ancho y las reparte en
+// tramos contiguos entre las colas. Se llama con los trabajadores detenidos.
+void repartir_baldosas(PlanificadorRobo* plan, int filas, int cols, int alto, int ancho);
+
+// Siguiente baldosa para el hilo id: primero la propia cola, luego robos.
+// Devuelve 0 cuando no queda trabajo en ninguna cola; *robos cuenta los
+// robos exitosos.
+int siguiente_baldosa(PlanificadorRobo* plan, int id, Baldosa* b, long* robos);
+
+// Tamaño de baldosa por defecto para n x n con num_hilos hilos
+void baldosa_defecto(int n, int num_hilos, int* alto, int* ancho);
+
+// Interpreta "FILASxCOLUMNAS" (por ejemplo "32x256"). Devuelve 0 si es válido.
+int parsear_baldosa(const char* texto, int* alto, int* ancho);
+
+#endif /* ROBO_TRABAJO_H_ */
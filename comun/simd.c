@@ -0,0 +1,67 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "simd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+
+// Bits de XCR0: estado SSE/AVX (1, 2) y opmask/ZMM (5, 6, 7)
+#define XCR0_AVX    0x06
+#define XCR0_AVX512 0xE6
+
+static unsigned long long leer_xcr0(void) {
+    unsigned int eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long) edx << 32) | eax;
+}
+
+static NivelSimd nivel_hardware(void) {
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return SIMD_ESCALAR;
+    int osxsave = (ecx & bit_OSXSAVE) != 0;
+    int fma = (ecx & bit_FMA) != 0;
+    if (!osxsave) return SIMD_ESCALAR;
+
+    unsigned long long xcr0 = leer_xcr0();
+    if ((xcr0 & XCR0_AVX) != XCR0_AVX) return SIMD_ESCALAR;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return SIMD_ESCALAR;
+    if ((ebx & bit_AVX512F) && (xcr0 & XCR0_AVX512) == XCR0_AVX512) return SIMD_AVX512;
+    if ((ebx & bit_AVX2) && fma) return SIMD_AVX2;
+    return SIMD_ESCALAR;
+}
+#else
+static NivelSimd nivel_hardware(void) {
+    return SIMD_ESCALAR;
+}
+#endif
+
+NivelSimd detectar_simd(void) {
+    static int detectado = 0;
+    static NivelSimd nivel = SIMD_ESCALAR;
+
+    if (!detectado) {
+        nivel = nivel_hardware();
+        const char* forzado = getenv("HPC_SIMD");
+        if (forzado != NULL) {
+            NivelSimd pedido = nivel;
+            if (strcmp(forzado, "escalar") == 0) pedido = SIMD_ESCALAR;
+            else if (strcmp(forzado, "avx2") == 0) pedido = SIMD_AVX2;
+            else if (strcmp(forzado, "avx512") == 0) pedido = SIMD_AVX512;
+            if (pedido < nivel) nivel = pedido;
+        }
+        detectado = 1;
+    }
+    return nivel;
+}
+
+const char* nombre_simd(NivelSimd nivel) {
+    switch (nivel) {
+        case SIMD_ESCALAR: return "escalar";
+        case SIMD_AVX2:    return "avx2";
+        case SIMD_AVX512:  return "avx512";
+    }
+    return "desconocido";
+}
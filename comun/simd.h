@@ -0,0 +1,18 @@
+#ifndef SIMD_H_
+#define SIMD_H_
+
+// Conjuntos de instrucciones vectoriales que aprovechan los kernels
+typedef enum {
+    SIMD_ESCALAR,
+    SIMD_AVX2,      // AVX2 + FMA
+    SIMD_AVX512     // AVX-512 F
+} NivelSimd;
+
+// Nivel soportado por la CPU y el sistema operativo (CPUID + XGETBV).
+// La variable de entorno HPC_SIMD=escalar|avx2|avx512 permite forzar un
+// nivel inferior para comparar kernels.
+NivelSimd detectar_simd(void);
+
+const char* nombre_simd(NivelSimd nivel);
+
+#endif /* SIMD_H_ */
@@ -2,40 +2,174 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <omp.h>
+#include <string.h>
 #include <time.h>
 
-int** reservar_matriz(int n) {
-    int** matriz = malloc(n * sizeof(int*));
-    for (int i = 0; i < n; i++) {
-        matriz[i] = malloc(n * sizeof(int));
-    }
-    return matriz;
-}
+#include "../comun/gemm.h"
+#include "../comun/matriz.h"
+#include "../comun/numa_hpc.h"
 
-void liberar_matriz(int** matriz, int n) {
-    for (int i = 0; i < n; i++) free(matriz[i]);
-    free(matriz);
-}
+// Motores de cálculo (--motor=...); tareas y strassen se comparan con el bucle
+typedef enum { MOTOR_BUCLE, MOTOR_TAREAS, MOTOR_STRASSEN } Motor;
 
-void llenar_matriz(int** matriz, int n) {
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++)
-            matriz[i][j] = rand() % 10;
+static const char* nombres_motor[] = {"bucle", "tareas", "strassen"};
+
+// B_hilo[t] es la copia de B que lee el hilo t (la de su nodo con --numa=replicado).
+// La unidad de trabajo es una línea de caché de C (16 enteros de una fila):
+// cada hilo acumula la línea en registros y la escribe entera, así que dos
+// hilos nunca comparten una línea de C.
+void multiplicar_matrices(const Matriz* A, const Matriz* const* B_hilo, Matriz* C, int n, int num_hilos) {
+    int lineas = (n + ELEMS_LINEA_INT - 1) / ELEMS_LINEA_INT;
+    #pragma omp parallel num_threads(num_hilos)
+    {
+        const Matriz* B = B_hilo[omp_get_thread_num()];
+        #pragma omp for collapse(2) schedule(static)
+        for (int i = 0; i < n; i++)
+            for (int l = 0; l < lineas; l++) {
+                int j = l * ELEMS_LINEA_INT;
+                int ancho = n - j < ELEMS_LINEA_INT ? n - j : ELEMS_LINEA_INT;
+                producto_linea_int(n, FILA(*A, i), B->datos + j, B->ld, FILA(*C, i) + j, ancho);
+            }
+    }
 }
 
-void multiplicar_matrices(int** A, int** B, int** C, int n, int num_hilos) {
-    #pragma omp parallel for num_threads(num_hilos) collapse(2)
+// Versión anterior (suma directa sobre C[i][j] repartiendo elementos sueltos),
+// sólo para --comparar
+void multiplicar_matrices_original(const Matriz* A, const Matriz* B, Matriz* C, int n, int num_hilos) {
+    #pragma omp parallel for collapse(2) num_threads(num_hilos)
     for (int i = 0; i < n; i++)
         for (int j = 0; j < n; j++) {
-            C[i][j] = 0;
+            ELEM(*C, i, j) = 0;
             for (int k = 0; k < n; k++)
-                C[i][j] += A[i][k] * B[k][j];
+                ELEM(*C, i, j) += ELEM(*A, i, k) * ELEM(*B, k, j);
         }
 }
 
+// Modo --comparar: kernel ingenuo anterior frente al de líneas de caché con
+// 2, 4, 8, ... hasta max_hilos hilos (tiempo medio por iteración)
+void comparar_kernels(const Matriz* A, const Matriz* B, int max_hilos, int iteraciones) {
+    int n = A->n;
+    Matriz C_original = reservar_matriz(n);
+    Matriz C = reservar_matriz(n);
+    const Matriz* B_hilo[max_hilos];
+    for (int i = 0; i < max_hilos; i++) B_hilo[i] = B;
+
+    FILE* archivo = fopen("comparacion.csv", "a");
+    for (int hilos = 2; hilos <= max_hilos; hilos *= 2) {
+        double inicio = omp_get_wtime();
+        for (int it = 0; it < iteraciones; it++) {
+            multiplicar_matrices_original(A, B, &C_original, n, hilos);
+        }
+        double t_original = (omp_get_wtime() - inicio) / iteraciones;
+
+        inicio = omp_get_wtime();
+        for (int it = 0; it < iteraciones; it++) {
+            multiplicar_matrices(A, B_hilo, &C, n, hilos);
+        }
+        double t_lineas = (omp_get_wtime() - inicio) / iteraciones;
+
+        int iguales = 1;
+        for (int i = 0; i < n && iguales; i++) {
+            iguales = memcmp(FILA(C, i), FILA(C_original, i), (size_t) n * sizeof(int)) == 0;
+        }
+        printf("Comparación: Tamaño: %d - Hilos: %d - Original: %.6f - Líneas: %.6f - Aceleración: %.2fx%s\n",
+               n, hilos, t_original, t_lineas, t_original / t_lineas, iguales ? "" : " - RESULTADOS DISTINTOS");
+        if (archivo != NULL) {
+            fprintf(archivo, "%d,%d,%.6f,%.6f\n", n, hilos, t_original, t_lineas);
+        }
+    }
+    if (archivo != NULL) fclose(archivo);
+    liberar_matriz(&C_original);
+    liberar_matriz(&C);
+}
+
+// Kernels de comun/gemm: cada hilo procesa su franja contigua de filas
+void multiplicar_kernel_paralelo(const Matriz* A, const Matriz* const* B_hilo, Matriz* C, int n,
+                                 int num_hilos, const OpcionesGemm* op) {
+    #pragma omp parallel num_threads(num_hilos)
+    {
+        int id = omp_get_thread_num(), total = omp_get_num_threads();
+        int inicio = (int) ((long) n * id / total);
+        int fin = (int) ((long) n * (id + 1) / total);
+        const Matriz* B = B_hilo[id];
+        if (fin > inicio)
+            multiplicar_int(op, fin - inicio, n, n, FILA(*A, inicio), A->ld,
+                            B->datos, B->ld, FILA(*C, inicio), C->ld);
+    }
+}
+
+// Ancla cada hilo a su nodo y hace el primer toque de sus filas de A, B y C
+// con el mismo reparto que el cálculo. Con --numa=replicado el primer hilo de
+// cada nodo copia B en memoria local y B_hilo apunta a esa copia.
+void inicializar_numa(Matriz* A, Matriz* B, Matriz* C, int n, int num_hilos,
+                      const TopologiaNuma* topo, ModoNuma modo,
+                      Matriz* replicas, const Matriz** B_hilo) {
+    unsigned semilla = (unsigned) time(NULL);
+
+    if (modo == NUMA_REPLICADO) {
+        for (int nodo = 0; nodo < topo->num_nodos; nodo++) {
+            replicas[nodo] = reservar_matriz(n);
+        }
+    }
+
+    #pragma omp parallel num_threads(num_hilos)
+    {
+        int id = omp_get_thread_num();
+        int inicio = (int) ((long) n * id / num_hilos);
+        int fin = (int) ((long) n * (id + 1) / num_hilos);
+        int nodo = nodo_de_hilo(topo, id, num_hilos);
+
+        fijar_hilo_nodo(topo, id, num_hilos);
+        llenar_filas(A, inicio, fin, semilla);
+        llenar_filas(B, inicio, fin, semilla * 31u + 7u);
+        for (int i = inicio; i < fin; i++) {
+            memset(FILA(*C, i), 0, (size_t) C->ld * sizeof(int));
+        }
+
+        if (modo == NUMA_REPLICADO) {
+            #pragma omp barrier
+            if (id == 0 || nodo != nodo_de_hilo(topo, id - 1, num_hilos)) {
+                copiar_filas(&replicas[nodo], B, 0, n);
+            }
+            B_hilo[id] = &replicas[nodo];
+        }
+    }
+}
+
 int main(int argc, char* argv[]) {
-    if (argc != 4) {
-        fprintf(stderr, "Uso: %s <tamaño_matriz> <num_hilos> <num_iteraciones>\n", argv[0]);
+    OpcionesGemm op;
+    opciones_gemm_defecto(&op, sizeof(int));
+    ModoNuma numa = NUMA_NO;
+    Motor motor = MOTOR_BUCLE;
+    int comparar = 0, corte = 0, valido = argc >= 4;   // corte 0: valor por defecto del motor
+    for (int i = 4; valido && i < argc; i++) {
+        int r = parsear_opcion_gemm(argv[i], &op);
+        if (r == 0 && strncmp(argv[i], "--numa=", 7) == 0) {
+            valido = parsear_modo_numa(argv[i] + 7, &numa) == 0;
+        } else if (r == 0 && strcmp(argv[i], "--comparar") == 0) {
+            comparar = 1;
+        } else if (r == 0 && strcmp(argv[i], "--motor=bucle") == 0) {
+            motor = MOTOR_BUCLE;
+        } else if (r == 0 && strcmp(argv[i], "--motor=tareas") == 0) {
+            motor = MOTOR_TAREAS;
+        } else if (r == 0 && strcmp(argv[i], "--motor=strassen") == 0) {
+            motor = MOTOR_STRASSEN;
+        } else if (r == 0 && strcmp(argv[i], "--corte=auto") == 0) {
+            corte = 0;
+        } else if (r == 0 && strncmp(argv[i], "--corte=", 8) == 0) {
+            corte = atoi(argv[i] + 8);
+            valido = corte > 0;
+        } else if (r == 0) {
+            fprintf(stderr, "Opción desconocida: %s\n", argv[i]);
+            valido = 0;
+        } else if (r < 0) {
+            valido = 0;
+        }
+    }
+    if (!valido) {
+        fprintf(stderr, "Uso: %s <tamaño_matriz> <num_hilos> <num_iteraciones> " OPCIONES_GEMM_USO
+                        " [--numa=no|primer-toque|intercalado|replicado] [--comparar]"
+                        " [--motor=bucle|tareas|strassen] [--corte=N|auto]\n", argv[0]);
         return EXIT_FAILURE;
     }
 
@@ -45,18 +179,82 @@ int main(int argc, char* argv[]) {
 
     srand(time(NULL));
 
-    int** A = reservar_matriz(n);
-    int** B = reservar_matriz(n);
-    int** C = reservar_matriz(n);
-    llenar_matriz(A, n);
-    llenar_matriz(B, n);
+    TopologiaNuma topo;
+    detectar_topologia(&topo);
+
+    Matriz A = reservar_matriz(n);
+    Matriz B = numa == NUMA_INTERCALADO ? reservar_matriz_intercalada(n, &topo) : reservar_matriz(n);
+    Matriz C = reservar_matriz(n);
+    Matriz replicas[NUMA_MAX_NODOS];
+    const Matriz* B_hilo[num_hilos];
+    for (int i = 0; i < num_hilos; i++) B_hilo[i] = &B;
+
+    if (comparar) {
+        llenar_matriz(&A);
+        llenar_matriz(&B);
+        comparar_kernels(&A, &B, num_hilos, iteraciones);
+        liberar_topologia(&topo);
+        liberar_matriz(&A);
+        liberar_matriz(&B);
+        liberar_matriz(&C);
+        return EXIT_SUCCESS;
+    }
+
+    if (numa == NUMA_NO) {
+        llenar_matriz(&A);
+        llenar_matriz(&B);
+    } else {
+        char reparto[256];
+        inicializar_numa(&A, &B, &C, n, num_hilos, &topo, numa, replicas, B_hilo);
+        describir_reparto(&topo, num_hilos, reparto, sizeof(reparto));
+        printf("NUMA: modo %s - nodos %d - hilos por nodo %s\n",
+               nombre_modo_numa(numa), topo.num_nodos, reparto);
+    }
+
+    // Los motores alternativos se comparan en cada iteración con el bucle actual.
+    // Strassen calibra el corte (salvo --corte=N) y reserva su arena una vez.
+    Matriz C_motor;
+    PlanStrassen plan;
+    if (motor == MOTOR_TAREAS && corte == 0) {
+        corte = CORTE_TAREAS_DEFECTO;
+    } else if (motor == MOTOR_STRASSEN) {
+        if (corte == 0) corte = calibrar_corte_strassen_int(n, num_hilos, &op);
+        plan = crear_plan_strassen(n, corte, num_hilos, sizeof(int), &op);
+    }
+    if (motor != MOTOR_BUCLE) {
+        C_motor = reservar_matriz(n);
+        printf("Motor: %s - corte %d\n", nombres_motor[motor], corte);
+    }
 
     for (int iter = 0; iter < iteraciones; iter++) {
         double inicio = omp_get_wtime();
-        multiplicar_matrices(A, B, C, n, num_hilos);
+        if (op.kernel != KERNEL_INGENUO)
+            multiplicar_kernel_paralelo(&A, B_hilo, &C, n, num_hilos, &op);
+        else
+            multiplicar_matrices(&A, B_hilo, &C, n, num_hilos);
         double fin = omp_get_wtime();
         double tiempo = fin - inicio;
 
+        if (motor != MOTOR_BUCLE) {
+            double tiempo_bucle = tiempo;
+            inicio = omp_get_wtime();
+            if (motor == MOTOR_TAREAS)
+                multiplicar_tareas_int(n, n, n, A.datos, A.ld, B.datos, B.ld,
+                                       C_motor.datos, C_motor.ld, corte, num_hilos, &op.bloques);
+            else
+                multiplicar_strassen_int(&plan, A.datos, A.ld, B.datos, B.ld,
+                                         C_motor.datos, C_motor.ld, &op);
+            tiempo = omp_get_wtime() - inicio;
+
+            int iguales = 1;
+            for (int i = 0; i < n && iguales; i++) {
+                iguales = memcmp(FILA(C, i), FILA(C_motor, i), (size_t) n * sizeof(int)) == 0;
+            }
+            printf("Comparación: Bucle: %.6f - %s: %.6f - Aceleración: %.2fx%s\n",
+                   tiempo_bucle, motor == MOTOR_TAREAS ? "Tareas" : "Strassen", tiempo,
+                   tiempo_bucle / tiempo, iguales ? "" : " - RESULTADOS DISTINTOS");
+        }
+
         printf("Ejecutado: matriz_openmp - Tamaño: %d - Iter: %d - Hilos: %d -> Tiempo: %.6f\n",
                n, iter + 1, num_hilos, tiempo);
         // Total FLOPs = 2 * N^3 (1 suma + 1 multiplicación por elemento)
@@ -66,9 +264,15 @@ int main(int argc, char* argv[]) {
         printf("Resultado: %.2f MFLOPS\n", mflops);
     }
 
-    liberar_matriz(A, n);
-    liberar_matriz(B, n);
-    liberar_matriz(C, n);
+    if (motor != MOTOR_BUCLE) liberar_matriz(&C_motor);
+    if (motor == MOTOR_STRASSEN) liberar_plan_strassen(&plan);
+    if (numa == NUMA_REPLICADO) {
+        for (int nodo = 0; nodo < topo.num_nodos; nodo++) liberar_matriz(&replicas[nodo]);
+    }
+    liberar_topologia(&topo);
+    liberar_matriz(&A);
+    liberar_matriz(&B);
+    liberar_matriz(&C);
 
     return EXIT_SUCCESS;
 }
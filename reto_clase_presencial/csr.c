@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "csr.h"
+
+#define LARGO_LINEA 1024
+
+static void* reservar(size_t bytes) {
+    void* p = malloc(bytes > 0 ? bytes : 1);
+    if (!p) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// Función para leer la cabecera "%%MatrixMarket ..." y saltar los comentarios.
+// Deja en `linea` la primera línea de datos (las dimensiones).
+static int leer_cabecera(FILE* fp, const char* ruta, char* cabecera, char* linea) {
+    if (!fgets(cabecera, LARGO_LINEA, fp) || strncmp(cabecera, "%%MatrixMarket", 14) != 0) {
+        fprintf(stderr, "%s: no es un archivo Matrix Market\n", ruta);
+        return -1;
+    }
+    do {
+        if (!fgets(linea, LARGO_LINEA, fp)) {
+            fprintf(stderr, "%s: faltan las dimensiones\n", ruta);
+            return -1;
+        }
+    } while (linea[0] == '%' || linea[0] == '\n');
+    return 0;
+}
+
+// Función para cargar una matriz Matrix Market en CSR
+int leer_matrix_market(const char* ruta, MatrizCSR* A) {
+    char cabecera[LARGO_LINEA], linea[LARGO_LINEA];
+    FILE* fp = fopen(ruta, "r");
+    if (!fp) {
+        perror(ruta);
+        return -1;
+    }
+    if (leer_cabecera(fp, ruta, cabecera, linea) != 0) {
+        fclose(fp);
+        return -1;
+    }
+
+    // "skew-symmetric" también contiene "symmetric": se descarta antes
+    int patron = strstr(cabecera, "pattern") != NULL;
+    int simetrica = strstr(cabecera, "symmetric") != NULL;
+    if (strstr(cabecera, "skew-symmetric") || strstr(cabecera, "hermitian")) {
+        fprintf(stderr, "%s: matrices skew-symmetric o hermitian no soportadas\n", ruta);
+        fclose(fp);
+        return -1;
+    }
+    int filas, columnas;
+    long entradas;
+    if (!strstr(cabecera, "coordinate") || strstr(cabecera, "complex") ||
+        sscanf(linea, "%d %d %ld", &filas, &columnas, &entradas) != 3 || filas != columnas || filas <= 0) {
+        fprintf(stderr, "%s: se espera una matriz cuadrada real en formato coordinate\n", ruta);
+        fclose(fp);
+        return -1;
+    }
+
+    // Tripletas (base 0); una simétrica guarda sólo un triángulo y se refleja
+    long capacidad = simetrica ? 2 * entradas : entradas;
+    int* fi = (int*) reservar(capacidad * sizeof(int));
+    int* co = (int*) reservar(capacidad * sizeof(int));
+    double* va = (double*) reservar(capacidad * sizeof(double));
+    long nnz = 0;
+    for (long k = 0; k < entradas; k++) {
+        int i, j;
+        double v = 1.0;
+        if (fscanf(fp, "%d %d", &i, &j) != 2 || (!patron && fscanf(fp, "%lf", &v) != 1) ||
+            i < 1 || i > filas || j < 1 || j > filas) {
+            fprintf(stderr, "%s: entrada %ld inválida\n", ruta, k + 1);
+            free(fi); free(co); free(va);
+            fclose(fp);
+            return -1;
+        }
+        fi[nnz] = i - 1; co[nnz] = j - 1; va[nnz] = v; nnz++;
+        if (simetrica && i != j) {
+            fi[nnz] = j - 1; co[nnz] = i - 1; va[nnz] = v; nnz++;
+        }
+    }
+    fclose(fp);
+
+    // Ordenamiento por conteo de las tripletas por fila
+    A->n = filas;
+    A->nnz = nnz;
+    A->inicio = (long*) reservar((filas + 1) * sizeof(long));
+    A->columnas = (int*) reservar(nnz * sizeof(int));
+    A->valores = (double*) reservar(nnz * sizeof(double));
+    memset(A->inicio, 0, (filas + 1) * sizeof(long));
+    for (long k = 0; k < nnz; k++) {
+        A->inicio[fi[k] + 1]++;
+    }
+    for (int i = 0; i < filas; i++) {
+        A->inicio[i + 1] += A->inicio[i];
+    }
+    long* siguiente = (long*) reservar(filas * sizeof(long));
+    memcpy(siguiente, A->inicio, filas * sizeof(long));
+    for (long k = 0; k < nnz; k++) {
+        long p = siguiente[fi[k]]++;
+        A->columnas[p] = co[k];
+        A->valores[p] = va[k];
+    }
+    free(siguiente);
+    free(fi); free(co); free(va);
+    return 0;
+}
+
+// Función para leer un vector Matrix Market "array" (una columna)
+int leer_vector_mm(const char* ruta, int n, double* v) {
+    char cabecera[LARGO_LINEA], linea[LARGO_LINEA];
+    FILE* fp = fopen(ruta, "r");
+    if (!fp) {
+        perror(ruta);
+        return -1;
+    }
+    int filas, columnas, ok = leer_cabecera(fp, ruta, cabecera, linea) == 0;
+    if (ok && (!strstr(cabecera, "array") || sscanf(linea, "%d %d", &filas, &columnas) != 2 ||
+               filas != n || columnas != 1)) {
+        fprintf(stderr, "%s: se espera un vector array de %d x 1\n", ruta, n);
+        ok = 0;
+    }
+    for (int i = 0; ok && i < n; i++) {
+        if (fscanf(fp, "%lf", &v[i]) != 1) {
+            fprintf(stderr, "%s: faltan valores (%d de %d)\n", ruta, i, n);
+            ok = 0;
+        }
+    }
+    fclose(fp);
+    return ok ? 0 : -1;
+}
+
+// Función para comprimir una matriz densa
+MatrizCSR csr_desde_densa(int n, const double* densa) {
+    MatrizCSR A;
+    A.n = n;
+    A.nnz = 0;
+    for (long k = 0; k < (long) n * n; k++) {
+        if (densa[k] != 0) A.nnz++;
+    }
+    A.inicio = (long*) reservar((n + 1) * sizeof(long));
+    A.columnas = (int*) reservar(A.nnz * sizeof(int));
+    A.valores = (double*) reservar(A.nnz * sizeof(double));
+    long p = 0;
+    for (int i = 0; i < n; i++) {
+        A.inicio[i] = p;
+        for (int j = 0; j < n; j++) {
+            if (densa[(long) i * n + j] != 0) {
+                A.columnas[p] = j;
+                A.valores[p++] = densa[(long) i * n + j];
+            }
+        }
+    }
+    A.inicio[n] = p;
+    return A;
+}
+
+// Función para liberar una matriz CSR
+void liberar_csr(MatrizCSR* A) {
+    free(A->inicio);
+    free(A->columnas);
+    free(A->valores);
+    A->inicio = NULL;
+    A->columnas = NULL;
+    A->valores = NULL;
+}
+
+// Función para el producto matriz-vector disperso
+void producto_csr(const MatrizCSR* A, const double* x, double* y) {
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < A->n; i++) {
+        double suma = 0.0;
+        for (long k = A->inicio[i]; k < A->inicio[i + 1]; k++) {
+            suma += A->valores[k] * x[A->columnas[k]];
+        }
+        y[i] = suma;
+    }
+}
+
+// Función para extraer la diagonal
+int diagonal_csr(const MatrizCSR* A, double* d) {
+    int faltan = 0;
+    for (int i = 0; i < A->n; i++) {
+        d[i] = 0.0;
+        for (long k = A->inicio[i]; k < A->inicio[i + 1]; k++) {
+            if (A->columnas[k] == i) d[i] += A->valores[k];
+        }
+        if (d[i] == 0.0) faltan++;
+    }
+    return faltan ? -1 : 0;
+}
@@ -0,0 +1,35 @@
+#ifndef CSR_H_
+#define CSR_H_
+
+/*
+ * Matriz dispersa n x n en formato CSR (filas comprimidas). La fila i ocupa
+ * las posiciones [inicio[i], inicio[i+1]) de `columnas` y `valores`, de modo
+ * que la memoria y el costo de un producto crecen con los no ceros, no con n^2.
+ */
+typedef struct {
+    int n;
+    long nnz;
+    long* inicio;       // n + 1 posiciones
+    int* columnas;      // nnz índices de columna (base 0)
+    double* valores;    // nnz valores
+} MatrizCSR;
+
+// Lee un archivo Matrix Market "coordinate" (real, integer o pattern;
+// general o symmetric) cuadrado. Devuelve 0, o -1 con un mensaje en stderr.
+int leer_matrix_market(const char* ruta, MatrizCSR* A);
+
+// Lee un vector de n valores en formato Matrix Market "array". 0 o -1.
+int leer_vector_mm(const char* ruta, int n, double* v);
+
+// Construye la matriz CSR con los no ceros de una matriz densa n x n por filas
+MatrizCSR csr_desde_densa(int n, const double* densa);
+
+void liberar_csr(MatrizCSR* A);
+
+// y = A x, con las filas repartidas entre los hilos OpenMP
+void producto_csr(const MatrizCSR* A, const double* x, double* y);
+
+// Copia la diagonal de A en d. Devuelve -1 si falta algún elemento diagonal.
+int diagonal_csr(const MatrizCSR* A, double* d);
+
+#endif /* CSR_H_ */
@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "csr.h"
+
+// Valores por defecto, los mismos de jsecuencial.c
+#define TOL 0.0001
+#define MAX_IT 1000
+
+// Sistema de ejemplo de jsecuencial.c, usado si no se da una matriz
+#define N_EJEMPLO 4
+static const double A_EJEMPLO[N_EJEMPLO * N_EJEMPLO] = {10, -1, 2, 0,
+                                                        -1, 11, -1, 3,
+                                                        2, -1, 10, -1,
+                                                        0, 3, -1, 8};
+static const double B_EJEMPLO[N_EJEMPLO] = {6, 25, -11, 15};
+
+// Hasta este tamaño se imprime la solución completa
+#define N_IMPRIMIR 10
+
+// Jacobi sobre CSR con la misma regla de parada que jsecuencial.c: cada
+// `cada` iteraciones se suma |x_nuevo - x_viejo| en el mismo recorrido que
+// calcula x_nuevo y se para si es menor que tol. Devuelve las iteraciones.
+static int jacobi_csr(const MatrizCSR* A, const double* b, const double* diag, double* x,
+                      double tol, int max_it, int cada, double* error) {
+    int n = A->n, it;
+    double* x_old = x;
+    double* x_new = (double*) malloc(n * sizeof(double));
+    if (!x_new) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+
+    *error = 0.0;
+    for (it = 0; it < max_it; it++) {
+        int comprobar = (it + 1) % cada == 0 || it + 1 == max_it;
+        double err = 0.0;
+
+        #pragma omp parallel for schedule(static) reduction(+:err)
+        for (int i = 0; i < n; i++) {
+            double sum = b[i];
+            for (long k = A->inicio[i]; k < A->inicio[i + 1]; k++) {
+                if (A->columnas[k] != i)
+                    sum -= A->valores[k] * x_old[A->columnas[k]];
+            }
+            x_new[i] = sum / diag[i];
+            if (comprobar)
+                err += fabs(x_new[i] - x_old[i]);
+        }
+        double* tmp = x_old; x_old = x_new; x_new = tmp;
+
+        if (comprobar) {
+            *error = err;
+            if (err < tol) {
+                it++;
+                break;
+            }
+        }
+    }
+
+    // La última iteración puede haber quedado en el vector auxiliar
+    if (x_old != x) {
+        memcpy(x, x_old, n * sizeof(double));
+        free(x_old);
+    } else {
+        free(x_new);
+    }
+    return it;
+}
+
+// Gradiente conjugado con precondicionador de Jacobi (A simétrica definida
+// positiva). Para cuando ||r|| / ||b|| < tol; el residuo sale gratis del
+// mismo recorrido que actualiza x y r. Devuelve las iteraciones.
+static int gc_csr(const MatrizCSR* A, const double* b, const double* diag, double* x,
+                  double tol, int max_it, double* error) {
+    int n = A->n, it;
+    double* r = (double*) malloc(n * sizeof(double));
+    double* z = (double*) malloc(n * sizeof(double));
+    double* p = (double*) malloc(n * sizeof(double));
+    double* q = (double*) malloc(n * sizeof(double));
+    if (!r || !z || !p || !q) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+
+    double bb = 0.0, rr = 0.0, rz = 0.0;
+    producto_csr(A, x, q);
+    #pragma omp parallel for schedule(static) reduction(+:bb, rr, rz)
+    for (int i = 0; i < n; i++) {
+        r[i] = b[i] - q[i];
+        p[i] = z[i] = r[i] / diag[i];
+        bb += b[i] * b[i];
+        rr += r[i] * r[i];
+        rz += r[i] * z[i];
+    }
+    if (bb == 0.0) bb = 1.0;
+    *error = sqrt(rr / bb);
+
+    for (it = 0; it < max_it && *error >= tol; it++) {
+        double pq = 0.0;
+        producto_csr(A, p, q);
+        #pragma omp parallel for schedule(static) reduction(+:pq)
+        for (int i = 0; i < n; i++) {
+            pq += p[i] * q[i];
+        }
+        double alfa = rz / pq;
+
+        // x, r, z y los productos escalares en un solo recorrido
+        double rr_nuevo = 0.0, rz_nuevo = 0.0;
+        #pragma omp parallel for schedule(static) reduction(+:rr_nuevo, rz_nuevo)
+        for (int i = 0; i < n; i++) {
+            x[i] += alfa * p[i];
+            r[i] -= alfa * q[i];
+            z[i] = r[i] / diag[i];
+            rr_nuevo += r[i] * r[i];
+            rz_nuevo += r[i] * z[i];
+        }
+        double beta = rz_nuevo / rz;
+        rz = rz_nuevo;
+        *error = sqrt(rr_nuevo / bb);
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++) {
+            p[i] = z[i] + beta * p[i];
+        }
+    }
+
+    free(q); free(p); free(z); free(r);
+    return it;
+}
+
+int main(int argc, char** argv) {
+    const char* ruta = NULL;
+    const char* ruta_b = NULL;
+    int gc = 0, max_it = MAX_IT, cada = 1, valido = 1;
+    double tol = TOL;
+
+    for (int i = 1; valido && i < argc; i++) {
+        if (strcmp(argv[i], "--metodo=jacobi") == 0) {
+            gc = 0;
+        } else if (strcmp(argv[i], "--metodo=gc") == 0) {
+            gc = 1;
+        } else if (strncmp(argv[i], "--tol=", 6) == 0) {
+            tol = atof(argv[i] + 6);
+        } else if (strncmp(argv[i], "--max-it=", 9) == 0) {
+            max_it = atoi(argv[i] + 9);
+        } else if (strncmp(argv[i], "--cada=", 7) == 0) {
+            cada = atoi(argv[i] + 7);
+        } else if (strncmp(argv[i], "--rhs=", 6) == 0) {
+            ruta_b = argv[i] + 6;
+        } else if (argv[i][0] != '-' && ruta == NULL) {
+            ruta = argv[i];
+        } else {
+            fprintf(stderr, "Opción desconocida: %s\n", argv[i]);
+            valido = 0;
+        }
+    }
+    if (!valido || tol <= 0 || max_it < 1 || cada < 1 || (ruta_b && !ruta)) {
+        fprintf(stderr, "Uso: %s [matriz.mtx] [--metodo=jacobi|gc] [--tol=%g] [--max-it=%d] [--cada=1] [--rhs=b.mtx]\n",
+                argv[0], TOL, MAX_IT);
+        return EXIT_FAILURE;
+    }
+
+    // Sin archivo se resuelve el sistema 4x4 de jsecuencial.c
+    MatrizCSR A;
+    if (ruta) {
+        if (leer_matrix_market(ruta, &A) != 0) return EXIT_FAILURE;
+    } else {
+        A = csr_desde_densa(N_EJEMPLO, A_EJEMPLO);
+    }
+    int n = A.n;
+
+    double* b = (double*) malloc(n * sizeof(double));
+    double* x = (double*) calloc(n, sizeof(double));
+    double* diag = (double*) malloc(n * sizeof(double));
+    if (!b || !x || !diag) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    int valida = diagonal_csr(&A, diag) == 0;
+    if (!valida) {
+        fprintf(stderr, "La matriz tiene ceros en la diagonal: Jacobi no aplica\n");
+    }
+
+    // Lado derecho: del archivo, del ejemplo o b = A * 1 (solución conocida)
+    int b_unos = 0;
+    if (valida && ruta_b) {
+        valida = leer_vector_mm(ruta_b, n, b) == 0;
+    } else if (valida && !ruta) {
+        memcpy(b, B_EJEMPLO, n * sizeof(double));
+    } else if (valida) {
+        for (int i = 0; i < n; i++) x[i] = 1.0;
+        producto_csr(&A, x, b);
+        memset(x, 0, n * sizeof(double));
+        b_unos = 1;
+    }
+    if (!valida) {
+        free(diag); free(x); free(b);
+        liberar_csr(&A);
+        return EXIT_FAILURE;
+    }
+
+    int hilos = 1;
+#ifdef _OPENMP
+    hilos = omp_get_max_threads();
+#endif
+    printf("Matriz: n = %d, nnz = %ld (%.1f por fila), %d hilos\n", n, A.nnz, (double) A.nnz / n, hilos);
+
+    struct timespec inicio, fin;
+    double error;
+    int it;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    if (gc)
+        it = gc_csr(&A, b, diag, x, tol, max_it, &error);
+    else
+        it = jacobi_csr(&A, b, diag, x, tol, max_it, cada, &error);
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    double tiempo = (fin.tv_sec - inicio.tv_sec) + (fin.tv_nsec - inicio.tv_nsec) / 1e9;
+
+    printf("Método: %s, tiempo %g s (%g s por iteración)\n",
+           gc ? "gradiente conjugado (precondicionador de Jacobi)" : "Jacobi", tiempo, tiempo / (it > 0 ? it : 1));
+    printf("Solución en %d iteraciones (error %g%s):\n", it, error, gc ? ", ||r||/||b||" : "");
+    if (n <= N_IMPRIMIR) {
+        for (int i = 0; i < n; i++) {
+            printf("x[%d] = %lf\n", i, x[i]);
+        }
+    }
+    if (b_unos) {
+        double max_dif = 0.0;
+        for (int i = 0; i < n; i++) {
+            if (fabs(x[i] - 1.0) > max_dif) max_dif = fabs(x[i] - 1.0);
+        }
+        printf("max|x - 1| = %g\n", max_dif);
+    }
+
+    free(diag); free(x); free(b);
+    liberar_csr(&A);
+    return 0;
+}
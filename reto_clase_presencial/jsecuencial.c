@@ -7,17 +7,31 @@
 #define TOL 0.0001
 #define MAX_IT 1000
 
-int main() {
+int main(int argc, char** argv) {
     double A[N][N] = {{10, -1, 2, 0},
                       {-1, 11, -1, 3},
                       {2, -1, 10, -1},
                       {0, 3, -1, 8}};
     double b[N] = {6, 25, -11, 15};
-    double x_old[N] = {0};
-    double x_new[N] = {0};
+    // Dos vectores que se alternan: el nuevo de una iteración es el viejo de la siguiente
+    double x[2][N] = {{0}};
+    int actual = 0;
+
+    // Comprobar la convergencia cada `cada` iteraciones (argumento opcional, 1 por defecto)
+    int cada = (argc > 1) ? atoi(argv[1]) : 1;
+    if (cada < 1) cada = 1;
 
     int it;
+    double error = 0.0;
     for (it = 0; it < MAX_IT; it++) {
+        const double* x_old = x[actual];
+        double* x_new = x[1 - actual];
+        int comprobar = (it + 1) % cada == 0 || it + 1 == MAX_IT;
+
+        // El error se acumula en el mismo recorrido que calcula x_new; sólo
+        // se reinicia al comprobar, así conserva la última medida
+        if (comprobar)
+            error = 0.0;
         for (int i = 0; i < N; i++) {
             double sum = b[i];
             for (int j = 0; j < N; j++) {
@@ -25,20 +39,20 @@ int main() {
                     sum -= A[i][j] * x_old[j];
             }
             x_new[i] = sum / A[i][i];
+            if (comprobar)
+                error += fabs(x_new[i] - x_old[i]);
         }
+        actual = 1 - actual;
 
-        double error = 0.0;
-        for (int i = 0; i < N; i++) {
-            error += fabs(x_new[i] - x_old[i]);
-            x_old[i] = x_new[i];
+        if (comprobar && error < TOL) {
+            it++;
+            break;
         }
-
-        if (error < TOL) break;
     }
 
-    printf("Solución en %d iteraciones:\n", it);
+    printf("Solución en %d iteraciones (error %g):\n", it, error);
     for (int i = 0; i < N; i++) {
-        printf("x[%d] = %lf\n", i, x_new[i]);
+        printf("x[%d] = %lf\n", i, x[actual][i]);
     }
 
     return 0;
@@ -1,9 +1,40 @@
+/* The SIMD, blocked, threaded and MPI kernels are checked bit for bit
+ * against jacobi(), so h2*f[i] + ... must not be fused into an FMA
+ * (-march=native, -xHost) in one kernel and not in another */
+#if defined(__GNUC__) && !defined(__clang__) && !defined(__INTEL_COMPILER)
+#pragma GCC optimize ("fp-contract=off")
+#else
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+#include <sched.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
+#include "multigrid1d.h"
+#include "sor1d.h"
+#include "stencil1d.h"
+#include "tridiag1d.h"
 #include "timing.h"
 
+/* Default temporal blocking: sweeps per tile and points per tile */
+#define BLOCK_DEPTH 64
+#define BLOCK_WIDTH 4096
+
+/* Default sweeps between convergence checks in tolerance mode */
+#define CHECK_EVERY 100
+
+/* Default tolerance of the multigrid mode, on the relative correction
+ * per cycle (the residual cannot drop much below eps*max|u|/h^2) */
+#define MG_TOL 1e-6
+
 /* --
  * Do nsweeps sweeps of Jacobi iteration on a 1D Poisson problem
  * 
@@ -39,6 +70,327 @@ void jacobi(int nsweeps, int n, double* u, double* f)
 }
 
 
+/* --
+ * Jacobi with early exit: like jacobi(), but every `every` sweeps
+ * (rounded up to a pair) the second sweep of the pair also measures the
+ * residual. Since the update is new = (u[i-1] + u[i+1] + h2*f[i])/2,
+ *
+ *    new - old = h2/2 * (f[i] - (-u[i-1] + 2 u[i] - u[i+1])/h2)
+ *
+ * so the residual of the iterate entering the sweep is 2/h2 times the
+ * update and costs one subtraction per point, with no extra pass over
+ * the arrays. Stops when max|r| <= tol * max|f| or after nsweeps sweeps.
+ * Returns the sweeps done; *residual gets the last relative residual.
+ */
+int jacobi_tol(int nsweeps, int n, double* u, double* f, double tol, int every,
+               double* residual)
+{
+    int i, sweep, check;
+    double h  = 1.0 / n;
+    double h2 = h*h;
+    double d, dmax, fmax = 0;
+    double* utmp = (double*) malloc( (n+1) * sizeof(double) );
+
+    for (i = 0; i <= n; ++i)
+        if (f[i] > fmax || -f[i] > fmax)
+            fmax = f[i] > 0 ? f[i] : -f[i];
+    if (fmax == 0)
+        fmax = 1;
+    every = 2 * ((every + 1) / 2);
+    *residual = -1;
+
+    /* Fill boundary conditions into utmp */
+    utmp[0] = u[0];
+    utmp[n] = u[n];
+
+    for (sweep = 0; sweep < nsweeps; sweep += 2) {
+        check = (sweep + 2) % every == 0 || sweep + 2 >= nsweeps;
+
+        /* Old data in u; new data in utmp */
+        for (i = 1; i < n; ++i)
+            utmp[i] = (u[i-1] + u[i+1] + h2*f[i])/2;
+
+        /* Old data in utmp; new data in u */
+        if (!check) {
+            for (i = 1; i < n; ++i)
+                u[i] = (utmp[i-1] + utmp[i+1] + h2*f[i])/2;
+            continue;
+        }
+        dmax = 0;
+        for (i = 1; i < n; ++i) {
+            u[i] = (utmp[i-1] + utmp[i+1] + h2*f[i])/2;
+            d = u[i] - utmp[i];
+            if (d > dmax || -d > dmax)
+                dmax = d > 0 ? d : -d;
+        }
+        *residual = 2 * dmax / h2 / fmax;
+        if (*residual <= tol) {
+            sweep += 2;
+            break;
+        }
+    }
+
+    free(utmp);
+    return sweep < nsweeps ? sweep : 2 * ((nsweeps + 1) / 2);
+}
+
+
+/* --
+ * Same sweeps as jacobi(), temporally blocked. The mesh is cut into
+ * tiles of `width` points and each tile is advanced `depth` sweeps
+ * while its data stays in cache, so u and f are streamed from memory
+ * once per `depth` sweeps instead of once per sweep.
+ *
+ * A tile copies the old values of its own points plus `depth` points on
+ * each side into two small local buffers. The valid region shrinks by
+ * one point per side and sweep (an overlapped trapezoid), and only the
+ * tile's own points are written back, into the other global array.
+ * Tiles therefore never see values already advanced by a neighbour.
+ * Every point is computed with the same expression as in jacobi(), so
+ * the result is bit-identical.
+ */
+void jacobi_blocked(int nsweeps, int n, double* u, double* f, int depth, int width)
+{
+    int i, s, done, steps, start, end, lo, hi, left, right;
+    int total = 2 * ((nsweeps + 1) / 2);    /* jacobi() does pairs of sweeps */
+    double h  = 1.0 / n;
+    double h2 = h*h;
+    double* unew = (double*) malloc( (n+1) * sizeof(double) );
+    double* a = (double*) malloc( (width + 2*depth) * sizeof(double) );
+    double* b = (double*) malloc( (width + 2*depth) * sizeof(double) );
+    double* src = u;
+    double* dst = unew;
+    double* tmp;
+
+    /* Boundary conditions are never overwritten in either array */
+    unew[0] = u[0];
+    unew[n] = u[n];
+
+    for (done = 0; done < total; done += steps) {
+        steps = (total - done < depth) ? total - done : depth;
+
+        for (start = 1; start < n; start += width) {
+            /* The tile owns [start, end) and reads [lo, hi) */
+            end = (start + width < n) ? start + width : n;
+            lo  = (start - steps > 0) ? start - steps : 0;
+            hi  = (end + steps < n + 1) ? end + steps : n + 1;
+            memcpy(a, src + lo, (hi - lo) * sizeof(double));
+            memcpy(b, src + lo, (hi - lo) * sizeof(double));
+
+            for (s = 1; s <= steps; ++s) {
+                /* A side on the domain boundary does not shrink */
+                left  = (lo == 0) ? 1 : lo + s;
+                right = (hi == n + 1) ? n : hi - s;
+                for (i = left; i < right; ++i)
+                    b[i-lo] = (a[i-1-lo] + a[i+1-lo] + h2*f[i])/2;
+                tmp = a; a = b; b = tmp;
+            }
+
+            memcpy(dst + start, a + (start - lo), (end - start) * sizeof(double));
+        }
+        tmp = src; src = dst; dst = tmp;
+    }
+
+    if (src != u)
+        memcpy(u, src, (n+1) * sizeof(double));
+
+    free(b);
+    free(a);
+    free(unew);
+}
+
+
+/* --
+ * Per-thread state shared with the neighbours, one cache line each so
+ * that spinning on a flag does not disturb the owner's other fields.
+ * `done` counts completed sweeps; `left`/`right` hold the thread's edge
+ * values after sweep done-1, in slot (done-1) % 2.
+ */
+#define CACHE_LINE 64
+#define SPINS_BEFORE_YIELD 1024
+
+typedef struct {
+    _Alignas(CACHE_LINE) atomic_int done;
+    double left[2];
+    double right[2];
+} neighbor_state_t;
+
+/* Wait until thread state st has completed at least `sweeps` sweeps */
+static void wait_for(neighbor_state_t* st, int sweeps)
+{
+    int spins = 0;
+    while (atomic_load_explicit(&st->done, memory_order_acquire) < sweeps) {
+        if (++spins == SPINS_BEFORE_YIELD) {
+            spins = 0;
+            sched_yield();      /* More threads than cores */
+        }
+    }
+}
+
+/* --
+ * Same sweeps as jacobi(), split across nthreads threads. Each thread
+ * keeps its chunk of the mesh in private arrays with one ghost cell per
+ * side. Before sweep s it waits only for its left and right neighbours
+ * to finish sweep s-1, then takes their edge values as its ghost cells.
+ * There is no global barrier, so threads drift up to one sweep apart
+ * and a slow thread only holds back its neighbours. The mailbox has two
+ * slots because a neighbour can read sweep s-1 while the owner is
+ * already publishing sweep s. Results are bit-identical to jacobi().
+ */
+void jacobi_threads(int nsweeps, int n, double* u, double* f, int nthreads)
+{
+    int total = 2 * ((nsweeps + 1) / 2);    /* jacobi() does pairs of sweeps */
+    double h  = 1.0 / n;
+    double h2 = h*h;
+    neighbor_state_t* state;
+
+    /* Every thread needs at least one interior point */
+    if (nthreads > n - 1)
+        nthreads = n - 1 > 1 ? n - 1 : 1;
+    state = (neighbor_state_t*) aligned_alloc(CACHE_LINE, nthreads * sizeof(neighbor_state_t));
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int i, s, id = 0, nt = 1;
+#ifdef _OPENMP
+        id = omp_get_thread_num();
+        nt = omp_get_num_threads();
+#endif
+        /* Interior points [lo, hi) of this thread */
+        int lo = 1 + (int) ((long) (n - 1) * id / nt);
+        int hi = 1 + (int) ((long) (n - 1) * (id + 1) / nt);
+        int m = hi - lo;
+        neighbor_state_t* me = &state[id];
+        neighbor_state_t* left  = id > 0      ? &state[id - 1] : NULL;
+        neighbor_state_t* right = id < nt - 1 ? &state[id + 1] : NULL;
+
+        /* Private copies (first touch by the owner), local index i <-> lo+i-1 */
+        double* a = (double*) malloc( (m + 2) * sizeof(double) );
+        double* b = (double*) malloc( (m + 2) * sizeof(double) );
+        double* tmp;
+        const double* fl = f + lo - 1;
+        memcpy(a, u + lo - 1, (m + 2) * sizeof(double));
+        b[0] = a[0];
+        b[m+1] = a[m+1];
+        atomic_store_explicit(&me->done, 0, memory_order_relaxed);
+        #pragma omp barrier
+
+        for (s = 0; s < total; ++s) {
+            /* Ghost cells: the neighbours' edges after sweep s-1 */
+            if (s > 0) {
+                if (left) {
+                    wait_for(left, s);
+                    a[0] = left->right[(s - 1) % 2];
+                }
+                if (right) {
+                    wait_for(right, s);
+                    a[m+1] = right->left[(s - 1) % 2];
+                }
+            }
+
+            for (i = 1; i <= m; ++i)
+                b[i] = (a[i-1] + a[i+1] + h2*fl[i])/2;
+            tmp = a; a = b; b = tmp;
+
+            /* Publish the new edges, then the sweep count (release) */
+            me->left[s % 2]  = a[1];
+            me->right[s % 2] = a[m];
+            atomic_store_explicit(&me->done, s + 1, memory_order_release);
+        }
+
+        memcpy(u + lo, a + 1, m * sizeof(double));
+        free(b);
+        free(a);
+    }
+
+    free(state);
+}
+
+
+/* --
+ * Reference for the float SIMD kernel: jacobi() in single precision,
+ * with the scaled right-hand side and operation order of stencil1d.c.
+ */
+void jacobi_float(int nsweeps, int n, double* u, double* f)
+{
+    int i, sweep;
+    double h  = 1.0 / n;
+    double h2 = h*h;
+    float* v    = (float*) malloc( (n+1) * sizeof(float) );
+    float* vtmp = (float*) malloc( (n+1) * sizeof(float) );
+    float* g    = (float*) malloc( (n+1) * sizeof(float) );
+
+    for (i = 0; i <= n; ++i) {
+        v[i] = vtmp[i] = (float) u[i];
+        g[i] = (float) (h2*f[i]);
+    }
+
+    for (sweep = 0; sweep < nsweeps; sweep += 2) {
+        for (i = 1; i < n; ++i)
+            vtmp[i] = (v[i-1] + v[i+1] + g[i]) * 0.5f;
+        for (i = 1; i < n; ++i)
+            v[i] = (vtmp[i-1] + vtmp[i+1] + g[i]) * 0.5f;
+    }
+
+    for (i = 1; i < n; ++i)
+        u[i] = v[i];
+    free(g);
+    free(vtmp);
+    free(v);
+}
+
+
+/* Largest |a[i] - b[i]| and, if max_ref is not NULL, largest |a[i]| */
+static double max_abs_diff(int n, const double* a, const double* b, double* max_ref)
+{
+    int i;
+    double diff, max_diff = 0;
+
+    if (max_ref)
+        *max_ref = 0;
+    for (i = 0; i <= n; ++i) {
+        diff = a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+        if (diff > max_diff)
+            max_diff = diff;
+        if (max_ref && (a[i] > *max_ref || -a[i] > *max_ref))
+            *max_ref = a[i] > 0 ? a[i] : -a[i];
+    }
+    return max_diff;
+}
+
+
+/* --
+ * Run the plain kernel (in float for single = 1) on a copy of the
+ * initial data and report whether the result of the selected kernel
+ * matches it bit for bit. For float, also report how far it is from
+ * the double plain kernel.
+ */
+void check_solution(int nsweeps, int n, const double* u0, const double* u, double* f, int single)
+{
+    double max_diff, max_ref;
+    const char* name = single ? "plain float kernel" : "plain kernel";
+    double* ref = (double*) malloc( (n+1) * sizeof(double) );
+
+    memcpy(ref, u0, (n+1) * sizeof(double));
+    if (single)
+        jacobi_float(nsweeps, n, ref, f);
+    else
+        jacobi(nsweeps, n, ref, f);
+    if (memcmp(ref, u, (n+1) * sizeof(double)) == 0)
+        printf("check: bit-identical to the %s\n", name);
+    else
+        printf("check: DIFFERS from the %s (max abs diff %g)\n", name, max_abs_diff(n, ref, u, NULL));
+
+    if (single) {
+        memcpy(ref, u0, (n+1) * sizeof(double));
+        jacobi(nsweeps, n, ref, f);
+        max_diff = max_abs_diff(n, ref, u, &max_ref);
+        printf("float vs double: max relative diff %g\n", max_ref > 0 ? max_diff / max_ref : max_diff);
+    }
+    free(ref);
+}
+
+
 void write_solution(int n, double* u, const char* fname)
 {
     int i;
@@ -50,21 +402,102 @@ void write_solution(int n, double* u, const char* fname)
 }
 
 
+void usage(const char* prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-b depth] [-w width] [-p threads] [-t tol] [-k every] [-m v|w] [-s jacobi|rb] [-o omega|auto] [-d] [-v double|float] [-c] [n] [nsteps] [fname]\n"
+            "  -b depth    temporal blocking: sweeps per cache-resident tile (0: off, try %d)\n"
+            "  -w width    points per tile with -b (default %d)\n"
+            "  -p threads  threaded sweeps with neighbour-only synchronization\n"
+            "  -t tol      stop when the relative residual max|r|/max|f| <= tol (nsteps: maximum)\n"
+            "  -k every    sweeps between residual checks with -t (default %d)\n"
+            "  -m v|w      multigrid V- or W-cycles (nsteps: maximum cycles; -t on the relative\n"
+            "              correction max|du|/max|u| per cycle, default %g)\n"
+            "  -s jacobi|rb  multigrid smoother: weighted Jacobi or red-black Gauss-Seidel\n"
+            "  -o omega|auto  in-place red-black SOR (nsteps: iterations; auto: 2/(1+sin(pi h)),\n"
+            "              1 for Gauss-Seidel; -p sets the OpenMP threads, -t/-k as above)\n"
+            "  -d          direct solve: Thomas algorithm, or partitioned over the -p threads\n"
+            "  -v double|float  explicit AVX2/AVX-512 sweeps (HPC_SIMD=escalar|avx2 to force lower);\n"
+            "              float halves the bytes per point, -c then checks against a float plain kernel\n"
+            "  -c          check the result bit for bit against the plain kernel\n",
+            prog, BLOCK_DEPTH, BLOCK_WIDTH, CHECK_EVERY, MG_TOL);
+}
+
+
 int main(int argc, char** argv)
 {
-    int i;
-    int n, nsteps;
+    int i, opt;
+    int n, nsteps, sweeps;
+    int depth = 0, width = BLOCK_WIDTH, nthreads = 0, check = 0, every = CHECK_EVERY;
+    double tol = 0, residual = 0, correction = 0;
+    int gamma = 0;                              /* Multigrid: 1 = V, 2 = W, 0 = off */
+    mg_smoother_t smoother = MG_SMOOTH_JACOBI;
+    double omega = 0;                           /* SOR: relaxation factor, 0 = off */
+    int direct = 0;
+    int simd = 0;                               /* Explicit SIMD: 1 = double, 2 = float, 0 = off */
+    multigrid_t* mg = NULL;
+    stencil_t* st = NULL;
     double* u;
+    double* u0 = NULL;
     double* f;
     double h;
     timing_t tstart, tend;
     char* fname;
 
-    /* Process arguments */
-    n      = (argc > 1) ? atoi(argv[1]) : 100;
-    nsteps = (argc > 2) ? atoi(argv[2]) : 100;
-    fname  = (argc > 3) ? argv[3] : NULL;
+    /* Process options, then the positional arguments */
+    while ((opt = getopt(argc, argv, "b:w:p:t:k:m:s:o:dv:c")) != -1) {
+        switch (opt) {
+        case 'b': depth = atoi(optarg); break;
+        case 'w': width = atoi(optarg); break;
+        case 'p': nthreads = atoi(optarg); break;
+        case 't': tol = atof(optarg); break;
+        case 'k': every = atoi(optarg); break;
+        case 'm':
+            gamma = strcmp(optarg, "v") == 0 ? 1 : strcmp(optarg, "w") == 0 ? 2 : -1;
+            break;
+        case 's':
+            if (strcmp(optarg, "rb") == 0)
+                smoother = MG_SMOOTH_RB;
+            else if (strcmp(optarg, "jacobi") != 0)
+                gamma = -1;
+            break;
+        case 'o':
+            omega = strcmp(optarg, "auto") == 0 ? -1 : atof(optarg);
+            if (omega != -1 && (omega <= 0 || omega >= 2))
+                gamma = -1;
+            break;
+        case 'd': direct = 1; break;
+        case 'v':
+            simd = strcmp(optarg, "double") == 0 ? 1 : strcmp(optarg, "float") == 0 ? 2 : -1;
+            break;
+        case 'c': check = 1; break;
+        default:  usage(argv[0]); return 1;
+        }
+    }
+    /* Kernels are exclusive; -t applies to the plain kernel, multigrid or SOR,
+     * -p also to SOR and to the direct solver */
+    if (depth < 0 || width < 1 || nthreads < 0 || tol < 0 || every < 1 || gamma < 0 || simd < 0 ||
+        (depth > 0) + (nthreads > 0 && !omega && !direct) + (gamma > 0) + (omega != 0) + direct +
+        (simd > 0) > 1 ||
+        (tol > 0 && (depth > 0 || nthreads > 0 || direct || simd) && !omega) ||
+        (check && (gamma > 0 || omega || direct))) {
+        usage(argv[0]);
+        return 1;
+    }
+    n      = (argc > optind)     ? atoi(argv[optind])     : 100;
+    nsteps = (argc > optind + 1) ? atoi(argv[optind + 1]) : 100;
+    fname  = (argc > optind + 2) ? argv[optind + 2] : NULL;
     h      = 1.0/n;
+    if (omega < 0)
+        omega = sor_optimal_omega(n);
+    if (omega > 0) {
+#ifdef _OPENMP
+        if (nthreads == 0)
+            nthreads = omp_get_max_threads();
+#else
+        nthreads = 1;
+#endif
+    }
 
     /* Allocate and initialize arrays */
     u = (double*) malloc( (n+1) * sizeof(double) );
@@ -72,22 +505,103 @@ int main(int argc, char** argv)
     memset(u, 0, (n+1) * sizeof(double));
     for (i = 0; i <= n; ++i)
         f[i] = i * h;
+    if (check) {
+        u0 = (double*) malloc( (n+1) * sizeof(double) );
+        memcpy(u0, u, (n+1) * sizeof(double));
+    }
+
+    /* The level hierarchy is set up outside the timed solve */
+    if (gamma > 0) {
+        mg = mg_create(n, gamma, smoother);
+        if (tol == 0)
+            tol = MG_TOL;
+    }
+
+    /* Aligned copies and the scaled right-hand side, also outside */
+    if (simd > 0)
+        st = stencil_create(n, u, f, simd == 2);
 
     /* Run the solver */
+    sweeps = nsteps;
     get_time(&tstart);
-    jacobi(nsteps, n, u, f);
+    if (gamma > 0)
+        sweeps = mg_solve(mg, u, f, tol, nsteps, &correction, &residual);
+    else if (direct && nthreads > 0)
+        nthreads = tridiag_poisson_threads(n, u, f, nthreads);
+    else if (direct)
+        tridiag_poisson(n, u, f);
+    else if (omega > 0)
+        sweeps = sor_solve(n, u, f, omega, tol, every, nsteps, nthreads, &residual);
+    else if (tol > 0)
+        sweeps = jacobi_tol(nsteps, n, u, f, tol, every, &residual);
+    else if (st)
+        stencil_sweeps(st, nsteps);
+    else if (depth > 0)
+        jacobi_blocked(nsteps, n, u, f, depth, width);
+    else if (nthreads > 0)
+        jacobi_threads(nsteps, n, u, f, nthreads);
+    else
+        jacobi(nsteps, n, u, f);
     get_time(&tend);
+    if (st) {
+        stencil_get(st, u);
+        stencil_destroy(st);
+    }
 
     /* Run the solver */    
     printf("n: %d\n"
            "nsteps: %d\n"
            "Elapsed time: %g s\n", 
-           n, nsteps, timespec_diff(tstart, tend));
+           n, nsteps, (double) timespec_diff(tstart, tend));
+    if (gamma > 0)
+        printf("kernel: multigrid %c(%d,%d), %s smoother, %d levels\n"
+               "cycles: %d\n"
+               "correction: %g (%s)\n"
+               "residual: %g\n",
+               gamma == 1 ? 'V' : 'W', mg->nu1, mg->nu2,
+               smoother == MG_SMOOTH_RB ? "red-black" : "weighted Jacobi", mg->levels,
+               sweeps, correction, correction <= tol ? "converged" :
+               sweeps < nsteps ? "stalled at round-off" : "not converged", residual);
+    else if (direct && nthreads > 0)
+        printf("kernel: direct, partitioned over %d threads\n", nthreads);
+    else if (direct)
+        printf("kernel: direct (Thomas)\n");
+    else if (omega > 0) {
+        printf("kernel: red-black SOR, omega %.6f, %d threads\n"
+               "iterations: %d\n",
+               omega, nthreads, sweeps);
+        if (tol > 0)
+            printf("residual: %g (%s)\n",
+                   residual, residual <= tol ? "converged" :
+                   sweeps < nsteps ? "stalled at round-off" : "not converged");
+    }
+    else if (simd > 0)
+        printf("kernel: SIMD %s, %s\n", stencil_isa(), simd == 1 ? "double" : "float");
+    else if (depth > 0)
+        printf("kernel: temporal blocking (depth %d, width %d)\n", depth, width);
+    else if (nthreads > 0)
+        printf("kernel: threads (%d, neighbour flags)\n", nthreads);
+    else if (tol > 0)
+        printf("kernel: tolerance %g, checked every %d sweeps\n"
+               "sweeps: %d\n"
+               "residual: %g (%s)\n",
+               tol, 2 * ((every + 1) / 2), sweeps, residual,
+               residual <= tol ? "converged" : "not converged");
+    else
+        printf("kernel: plain\n");
+
+    if (check) {
+        check_solution(sweeps, n, u0, u, f, simd == 2);
+        free(u0);
+    }
 
     /* Write the results */
     if (fname)
         write_solution(n, u, fname);
 
+    if (mg)
+        mg_destroy(mg);
+
     free(f);
     free(u);
     return 0;
@@ -0,0 +1,283 @@
+/* The results are compared bit for bit with jacobi1d, so h2*f[i] + ...
+ * must not be fused into an FMA (-march=native, -xHost) */
+#if defined(__GNUC__) && !defined(__clang__) && !defined(__INTEL_COMPILER)
+#pragma GCC optimize ("fp-contract=off")
+#else
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "tridiag1d.h"
+
+/* Default halo depth: sweeps between exchanges */
+#define HALO_DEPTH 16
+
+/* Upper bound on the length of one "%g %g\n" line of the solution */
+#define LINE_MAX_CHARS 64
+
+/* --
+ * Distributed version of jacobi1d: the interior points 1..n-1 are split
+ * into contiguous blocks, one per rank. Each rank keeps its block plus a
+ * halo of `halo` points on each side.
+ *
+ * After a halo exchange a rank can do `halo` sweeps on its own. The
+ * valid region shrinks by one point per side and sweep, so the halo
+ * points are recomputed redundantly instead of exchanged every sweep.
+ * One message of `halo` points then replaces `halo` one-point messages.
+ *
+ * The exchange uses MPI_Isend/MPI_Irecv. The first sweep after an
+ * exchange updates the points that need no halo data while the messages
+ * are in flight. Every point is computed with the same expression as in
+ * jacobi1d.c, so the results are identical to the serial solver.
+ */
+typedef struct {
+    int n, lo, hi;          /* Global mesh size and owned interior points [lo, hi) */
+    int halo;               /* Halo points per side (array offset of lo) */
+    int left, right;        /* Neighbour ranks or MPI_PROC_NULL */
+    double* u;              /* Current values, global g at u[g - lo + halo] */
+    double* utmp;
+    double* f;
+} domain_t;
+
+#define L(d, g) ((g) - (d)->lo + (d)->halo)
+
+/* Update points [g0, g1) from src into dst */
+static void sweep_range(const domain_t* d, const double* src, double* dst, int g0, int g1, double h2)
+{
+    int g;
+    for (g = g0; g < g1; ++g)
+        dst[L(d, g)] = (src[L(d, g-1)] + src[L(d, g+1)] + h2*d->f[L(d, g)])/2;
+}
+
+/* --
+ * Do nsweeps sweeps (rounded up to an even number, like jacobi()) with a
+ * halo exchange every d->halo sweeps. Returns the number of exchanges.
+ */
+int jacobi_mpi(int nsweeps, domain_t* d)
+{
+    int total = 2 * ((nsweeps + 1) / 2);
+    int done, s, steps, exchanges = 0;
+    int lo = d->lo, hi = d->hi;
+    double h  = 1.0 / d->n;
+    double h2 = h*h;
+    double* tmp;
+    MPI_Request req[4];
+
+    for (done = 0; done < total; done += steps) {
+        steps = (total - done < d->halo) ? total - done : d->halo;
+
+        /* Halo of `steps` points from each neighbour (boundaries stay fixed) */
+        MPI_Irecv(d->u + L(d, lo - steps), steps, MPI_DOUBLE, d->left, 0, MPI_COMM_WORLD, &req[0]);
+        MPI_Irecv(d->u + L(d, hi), steps, MPI_DOUBLE, d->right, 1, MPI_COMM_WORLD, &req[1]);
+        MPI_Isend(d->u + L(d, lo), steps, MPI_DOUBLE, d->left, 1, MPI_COMM_WORLD, &req[2]);
+        MPI_Isend(d->u + L(d, hi - steps), steps, MPI_DOUBLE, d->right, 0, MPI_COMM_WORLD, &req[3]);
+        ++exchanges;
+
+        for (s = 1; s <= steps; ++s) {
+            /* Valid region after sweep s; a side on the domain boundary does not shrink */
+            int g0 = (d->left  != MPI_PROC_NULL) ? lo - steps + s : 1;
+            int g1 = (d->right != MPI_PROC_NULL) ? hi + steps - s : d->n;
+
+            if (s == 1) {
+                /* Points whose neighbours are all owned, while the halo travels */
+                int a = lo + 1, b = hi - 1;
+                if (a > b)
+                    a = b = lo;
+                sweep_range(d, d->u, d->utmp, a, b, h2);
+                MPI_Waitall(4, req, MPI_STATUSES_IGNORE);
+                sweep_range(d, d->u, d->utmp, g0, a, h2);
+                sweep_range(d, d->u, d->utmp, b, g1, h2);
+            } else {
+                sweep_range(d, d->u, d->utmp, g0, g1, h2);
+            }
+            tmp = d->u; d->u = d->utmp; d->utmp = tmp;
+        }
+    }
+    return exchanges;
+}
+
+
+/* --
+ * Direct solve with the partitioned solver of tridiag1d.c. The last
+ * owned point of every rank but the last is a separator, the rest of
+ * the block is solved locally with zero boundary values. Rank 0 gathers
+ * the block end values, solves the separator system and broadcasts it.
+ */
+void tridiag_mpi(domain_t* d, int rank, int size)
+{
+    int hi = (rank < size - 1) ? d->hi - 1 : d->hi;     /* Block [lo, hi) */
+    double h = 1.0 / d->n;
+    double* x = d->u + L(d, d->lo);
+    double* xsep = (double*) malloc((size + 1) * sizeof(double));
+    tridiag_block_t mine, *all = NULL;
+
+    mine.m = hi - d->lo;
+    tridiag_solve(mine.m, x, d->f + L(d, d->lo), h*h, 0, 0);
+    mine.first = mine.m > 0 ? x[0] : 0;
+    mine.last  = mine.m > 0 ? x[mine.m - 1] : 0;
+    /* The last rank has no separator and sends the boundary value u[n] */
+    mine.rhs = (rank < size - 1) ? h*h*d->f[L(d, hi)] : d->u[L(d, d->n)];
+
+    if (rank == 0)
+        all = (tridiag_block_t*) malloc(size * sizeof(tridiag_block_t));
+    MPI_Gather(&mine, sizeof(mine), MPI_BYTE, all, sizeof(mine), MPI_BYTE, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        xsep[0] = d->u[L(d, 0)];
+        xsep[size] = all[size - 1].rhs;
+        tridiag_separators(size, all, xsep);
+        free(all);
+    }
+    MPI_Bcast(xsep, size + 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    if (rank < size - 1)
+        d->u[L(d, hi)] = xsep[rank + 1];
+    tridiag_correct(mine.m, x, xsep[rank], xsep[rank + 1]);
+    free(xsep);
+}
+
+
+/* --
+ * Write the solution in the same text format as write_solution() in
+ * jacobi1d.c. Each rank formats its own points, an exclusive prefix sum
+ * of the byte counts gives its file offset, and all ranks write at once
+ * with MPI_File_write_at_all, so rank 0 never holds the whole solution.
+ */
+void write_solution_mpi(const domain_t* d, const char* fname, int rank, int size)
+{
+    int g, g0, g1;
+    double h = 1.0 / d->n;
+    long long len = 0, offset = 0;
+    MPI_File fh;
+
+    /* Rank 0 also writes u[0] and the last rank u[n] */
+    g0 = (rank == 0) ? 0 : d->lo;
+    g1 = (rank == size - 1) ? d->n + 1 : d->hi;
+    char* text = (char*) malloc((size_t) (g1 - g0) * LINE_MAX_CHARS + 1);
+    for (g = g0; g < g1; ++g)
+        len += sprintf(text + len, "%g %g\n", g*h, d->u[L(d, g)]);
+
+    MPI_Exscan(&len, &offset, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    if (rank == 0)
+        offset = 0;
+
+    MPI_File_open(MPI_COMM_WORLD, fname, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+    MPI_File_set_size(fh, 0);
+    MPI_File_write_at_all(fh, offset, text, (int) len, MPI_CHAR, MPI_STATUS_IGNORE);
+    MPI_File_close(&fh);
+    free(text);
+}
+
+
+void usage(const char* prog)
+{
+    fprintf(stderr,
+            "Usage: mpirun -np P %s [-k halo] [-d] [n] [nsteps] [fname]\n"
+            "  -k halo  sweeps between halo exchanges (default %d)\n"
+            "  -d       direct solve, one block per rank (nsteps is ignored)\n",
+            prog, HALO_DEPTH);
+}
+
+
+int main(int argc, char** argv)
+{
+    int i, g, opt, rank, size, exchanges;
+    int n, nsteps, halo = HALO_DEPTH, min_block, direct = 0;
+    double h, tstart, tend;
+    char* fname;
+    domain_t d;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    /* Process options, then the same positional arguments as jacobi1d */
+    while ((opt = getopt(argc, argv, "k:d")) != -1) {
+        switch (opt) {
+        case 'k': halo = atoi(optarg); break;
+        case 'd': direct = 1; break;
+        default:
+            if (rank == 0) usage(argv[0]);
+            MPI_Finalize();
+            return 1;
+        }
+    }
+    n      = (argc > optind)     ? atoi(argv[optind])     : 100;
+    nsteps = (argc > optind + 1) ? atoi(argv[optind + 1]) : 100;
+    fname  = (argc > optind + 2) ? argv[optind + 2] : NULL;
+    h      = 1.0/n;
+
+    if (halo < 1 || n - 1 < size) {
+        if (rank == 0) {
+            if (halo < 1)
+                usage(argv[0]);
+            else
+                fprintf(stderr, "Error: %d interior points cannot be split over %d ranks\n", n - 1, size);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    /* Block of interior points and neighbours */
+    d.n = n;
+    d.lo = 1 + (int) ((long) (n - 1) * rank / size);
+    d.hi = 1 + (int) ((long) (n - 1) * (rank + 1) / size);
+    d.left  = (rank > 0) ? rank - 1 : MPI_PROC_NULL;
+    d.right = (rank < size - 1) ? rank + 1 : MPI_PROC_NULL;
+
+    /* A halo can come only from the adjacent rank: no deeper than the smallest block */
+    min_block = (n - 1) / size;
+    if (halo > min_block) {
+        if (rank == 0 && !direct)
+            printf("halo reduced from %d to %d (smallest block)\n", halo, min_block);
+        halo = min_block;
+    }
+    d.halo = halo;
+
+    /* Allocate and initialize arrays (global index clamped to [0, n]) */
+    d.u    = (double*) malloc( (d.hi - d.lo + 2*halo) * sizeof(double) );
+    d.utmp = (double*) malloc( (d.hi - d.lo + 2*halo) * sizeof(double) );
+    d.f    = (double*) malloc( (d.hi - d.lo + 2*halo) * sizeof(double) );
+    for (i = 0; i < d.hi - d.lo + 2*halo; ++i) {
+        g = d.lo - halo + i;
+        d.u[i] = d.utmp[i] = 0;
+        d.f[i] = (g >= 0 && g <= n) ? g * h : 0;
+    }
+
+    /* Run the solver */
+    MPI_Barrier(MPI_COMM_WORLD);
+    tstart = MPI_Wtime();
+    exchanges = 0;
+    if (direct)
+        tridiag_mpi(&d, rank, size);
+    else
+        exchanges = jacobi_mpi(nsteps, &d);
+    MPI_Barrier(MPI_COMM_WORLD);
+    tend = MPI_Wtime();
+
+    if (rank == 0) {
+        printf("n: %d\n"
+               "nsteps: %d\n"
+               "Elapsed time: %g s\n"
+               "processes: %d\n",
+               n, nsteps, tend - tstart, size);
+        if (direct)
+            printf("kernel: direct, partitioned over %d ranks\n", size);
+        else
+            printf("halo: %d (%d exchanges)\n", halo, exchanges);
+    }
+
+    /* Write the results */
+    if (fname)
+        write_solution_mpi(&d, fname, rank, size);
+
+    free(d.f);
+    free(d.utmp);
+    free(d.u);
+    MPI_Finalize();
+    return 0;
+}
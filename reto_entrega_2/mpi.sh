@@ -0,0 +1,13 @@
+#!/bin/bash
+#SBATCH --partition=all  	#Seleccione los nodos para el trabajo de todos el conjunto de nodos de cómputo del cluster
+#SBATCH -o MPI.%j.out    	#Nombre del archivo de salida
+#SBATCH -J MPI	        	#Nombre del trabajo
+#SBATCH --ntasks=8      	#Número de procesos MPI
+
+source /usr/local/intel/parallel_studio_xe_2016.3.067/psxevars.sh intel64 2> /dev/null
+ulimit -s unlimited -c unlimited
+
+N=100000
+NSTEPS=1000
+HALO=16		#Barridos entre intercambios de halo
+mpirun ./jacobi1d_mpi -k $HALO $N $NSTEPS u_mpi.out > timing_mpi.out
@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "multigrid1d.h"
+
+#define MG_NU1 2
+#define MG_NU2 2
+#define MG_OMEGA (2.0/3.0)
+#define MG_STALL 0.9    /* Correction reduction per cycle that counts as stalled */
+
+static double* alloc_level_array(int n)
+{
+    double* p = (double*) calloc(n + 1, sizeof(double));
+    if (!p) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+multigrid_t* mg_create(int n, int gamma, mg_smoother_t smoother)
+{
+    int l, nl;
+    multigrid_t* mg = (multigrid_t*) malloc(sizeof(multigrid_t));
+
+    mg->levels = 1;
+    for (nl = n; nl % 2 == 0 && nl > 2; nl /= 2)
+        mg->levels++;
+    mg->gamma = gamma;
+    mg->nu1 = MG_NU1;
+    mg->nu2 = MG_NU2;
+    mg->smoother = smoother;
+    mg->lv = (mg_level_t*) malloc(mg->levels * sizeof(mg_level_t));
+    mg->uprev = alloc_level_array(n);
+
+    for (l = 0, nl = n; l < mg->levels; ++l, nl /= 2) {
+        mg_level_t* lv = &mg->lv[l];
+        double h = 1.0 / nl;
+        lv->n = nl;
+        lv->h2 = h*h;
+        /* Level 0 uses the caller's u and f */
+        lv->u = (l > 0) ? alloc_level_array(nl) : NULL;
+        lv->f = (l > 0) ? alloc_level_array(nl) : NULL;
+        lv->r = alloc_level_array(nl);
+        lv->tmp = alloc_level_array(nl);
+    }
+    return mg;
+}
+
+void mg_destroy(multigrid_t* mg)
+{
+    int l;
+    free(mg->uprev);
+    for (l = 0; l < mg->levels; ++l) {
+        free(mg->lv[l].tmp);
+        free(mg->lv[l].r);
+        if (l > 0) {
+            free(mg->lv[l].f);
+            free(mg->lv[l].u);
+        }
+    }
+    free(mg->lv);
+    free(mg);
+}
+
+static void smooth(const multigrid_t* mg, mg_level_t* lv, int sweeps)
+{
+    int i, s, n = lv->n;
+    double* u = lv->u;
+    const double* f = lv->f;
+    double h2 = lv->h2;
+
+    for (s = 0; s < sweeps; ++s) {
+        if (mg->smoother == MG_SMOOTH_RB) {
+            for (i = 1; i < n; i += 2)
+                u[i] = (u[i-1] + u[i+1] + h2*f[i])/2;
+            for (i = 2; i < n; i += 2)
+                u[i] = (u[i-1] + u[i+1] + h2*f[i])/2;
+        } else {
+            for (i = 1; i < n; ++i)
+                lv->tmp[i] = (u[i-1] + u[i+1] + h2*f[i])/2;
+            for (i = 1; i < n; ++i)
+                u[i] += MG_OMEGA * (lv->tmp[i] - u[i]);
+        }
+    }
+}
+
+/* r = f - A u; returns max|r| */
+static double residual(mg_level_t* lv)
+{
+    int i;
+    double ri, rmax = 0;
+    for (i = 1; i < lv->n; ++i) {
+        ri = lv->f[i] - (2*lv->u[i] - lv->u[i-1] - lv->u[i+1]) / lv->h2;
+        lv->r[i] = ri;
+        if (ri > rmax || -ri > rmax)
+            rmax = ri > 0 ? ri : -ri;
+    }
+    return rmax;
+}
+
+/* Exact solve of (2 u[i] - u[i-1] - u[i+1]) / h2 = f[i] by the Thomas algorithm */
+static void coarse_solve(mg_level_t* lv)
+{
+    int i, n = lv->n;
+    double* c = lv->tmp;        /* Modified super-diagonal */
+    double* u = lv->u;
+    double m;
+
+    if (n < 2)
+        return;
+    /* Forward elimination; u holds the modified right-hand side and
+     * the boundary values enter the first and last rows */
+    for (i = 1; i < n; ++i) {
+        m = (i == 1) ? 2 : 2 + c[i-1];
+        c[i] = -1.0 / m;
+        u[i] = (lv->h2*lv->f[i] + u[i-1] + (i == n-1 ? u[n] : 0)) / m;
+    }
+    /* Back substitution */
+    for (i = n - 2; i >= 1; --i)
+        u[i] -= c[i] * u[i+1];
+}
+
+static void cycle(multigrid_t* mg, int l)
+{
+    int i, k;
+    mg_level_t* lv = &mg->lv[l];
+    mg_level_t* c;
+
+    if (l == mg->levels - 1) {
+        coarse_solve(lv);
+        return;
+    }
+
+    smooth(mg, lv, mg->nu1);
+    residual(lv);
+
+    /* Full weighting onto the coarse level; the correction starts at 0 */
+    c = &mg->lv[l+1];
+    for (i = 1; i < c->n; ++i)
+        c->f[i] = (lv->r[2*i-1] + 2*lv->r[2*i] + lv->r[2*i+1]) / 4;
+    memset(c->u, 0, (c->n + 1) * sizeof(double));
+
+    for (k = 0; k < mg->gamma; ++k)
+        cycle(mg, l + 1);
+
+    /* Linear interpolation of the correction (zero on the boundary) */
+    for (i = 0; i < c->n; ++i) {
+        lv->u[2*i]   += c->u[i];
+        lv->u[2*i+1] += (c->u[i] + c->u[i+1]) / 2;
+    }
+
+    smooth(mg, lv, mg->nu2);
+}
+
+int mg_solve(multigrid_t* mg, double* u, double* f, double tol, int max_cycles,
+             double* correction_out, double* residual_out)
+{
+    int i, cycles = 0;
+    double fmax = 0, d, dmax, umax, corr = 1, prev;
+    mg_level_t* fine = &mg->lv[0];
+
+    fine->u = u;
+    fine->f = f;
+    for (i = 0; i <= fine->n; ++i)
+        if (f[i] > fmax || -f[i] > fmax)
+            fmax = f[i] > 0 ? f[i] : -f[i];
+    if (fmax == 0)
+        fmax = 1;
+    memcpy(mg->uprev, u, (fine->n + 1) * sizeof(double));
+
+    while (corr > tol && cycles < max_cycles) {
+        cycle(mg, 0);
+        ++cycles;
+
+        /* Correction of this cycle, saving u for the next one */
+        dmax = umax = 0;
+        for (i = 1; i < fine->n; ++i) {
+            d = u[i] - mg->uprev[i];
+            if (d > dmax || -d > dmax)
+                dmax = d > 0 ? d : -d;
+            if (u[i] > umax || -u[i] > umax)
+                umax = u[i] > 0 ? u[i] : -u[i];
+            mg->uprev[i] = u[i];
+        }
+        prev = corr;
+        corr = (umax > 0) ? dmax / umax : dmax;
+        /* The first correction is the whole solution, nothing to compare */
+        if (cycles > 1 && corr > MG_STALL * prev)
+            break;
+    }
+
+    *residual_out = residual(fine) / fmax;
+    *correction_out = corr;
+    /* Level 0 arrays belong to the caller */
+    fine->u = NULL;
+    fine->f = NULL;
+    return cycles;
+}
@@ -0,0 +1,138 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "sor1d.h"
+
+#define SOR_STALL 0.9   /* Residual change per window of n iterations that counts as stalled */
+
+double sor_optimal_omega(int n)
+{
+    return 2.0 / (1.0 + sin(M_PI / n));
+}
+
+static double* alloc_half(int len)
+{
+    double* p = (double*) malloc(len * sizeof(double));
+    if (!p) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+int sor_solve(int n, double* u, const double* f, double omega, double tol, int every,
+              int max_iters, int nthreads, double* residual)
+{
+    int ne = n / 2 + 1;         /* Even points 0, 2, ..., including u[n] if n is even */
+    int no = (n + 1) / 2;       /* Odd points 1, 3, ..., including u[n] if n is odd */
+    double h  = 1.0 / n;
+    double h2 = h*h;
+    double fmax = 0, rmax = 0;
+    double* restrict e  = alloc_half(ne);
+    double* restrict o  = alloc_half(no);
+    double* restrict fe = alloc_half(ne);
+    double* restrict fo = alloc_half(no);
+    int iters = 0, i;
+
+    for (i = 0; i <= n; ++i)
+        if (fabs(f[i]) > fmax)
+            fmax = fabs(f[i]);
+    if (fmax == 0)
+        fmax = 1;
+    *residual = -1;
+#ifdef _OPENMP
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+#else
+    (void) nthreads;
+#endif
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int j, it, stop = 0;
+        int ref_it = 0;         /* Iteration and residual at the start of the stall window */
+        double r, ref = -1;
+
+        /* Split (first touch by the threads that update each part) */
+        #pragma omp for
+        for (j = 0; j < ne; ++j) {
+            e[j]  = u[2*j];
+            fe[j] = f[2*j];
+        }
+        #pragma omp for
+        for (j = 0; j < no; ++j) {
+            o[j]  = u[2*j+1];
+            fo[j] = f[2*j+1];
+        }
+
+        for (it = 0; it < max_iters && !stop; ++it) {
+            /* Red: odd interior points 1, 3, ..., i <= n-1 */
+            #pragma omp for simd
+            for (j = 0; j < n / 2; ++j)
+                o[j] += omega * ((e[j] + e[j+1] + h2*fo[j])/2 - o[j]);
+
+            /* Black: even interior points 2, 4, ..., i <= n-1 */
+            #pragma omp for simd
+            for (j = 1; j <= (n - 1) / 2; ++j)
+                e[j] += omega * ((o[j-1] + o[j] + h2*fe[j])/2 - e[j]);
+
+            if (tol > 0 && ((it + 1) % every == 0 || it + 1 == max_iters)) {
+                /* max|f - Au| over the interior, in split storage */
+                #pragma omp single
+                rmax = 0;
+                #pragma omp for simd reduction(max:rmax)
+                for (j = 0; j < n / 2; ++j) {
+                    r = fabs(fo[j] - (2*o[j] - e[j] - e[j+1]) / h2);
+                    rmax = r > rmax ? r : rmax;
+                }
+                #pragma omp for simd reduction(max:rmax)
+                for (j = 1; j <= (n - 1) / 2; ++j) {
+                    r = fabs(fe[j] - (2*e[j] - o[j-1] - o[j]) / h2);
+                    rmax = r > rmax ? r : rmax;
+                }
+                stop = rmax / fmax <= tol;
+
+                /* With the optimal omega the residual first grows by orders
+                 * of magnitude (about n/2 iterations), then falls by about
+                 * exp(-2 pi) every n iterations. A window of n iterations in
+                 * which it moves by less than SOR_STALL either way means the
+                 * round-off floor was reached. All threads see the same rmax. */
+                if (ref < 0) {
+                    ref = rmax;
+                    ref_it = it + 1;
+                } else if (it + 1 - ref_it >= n) {
+                    if (rmax > SOR_STALL * ref && SOR_STALL * rmax < ref)
+                        stop = 1;
+                    ref = rmax;
+                    ref_it = it + 1;
+                }
+            }
+        }
+
+        #pragma omp single
+        {
+            iters = it;
+            if (tol > 0 && it > 0)
+                *residual = rmax / fmax;
+        }
+
+        /* Merge back into u */
+        #pragma omp for
+        for (j = 0; j < ne; ++j)
+            u[2*j] = e[j];
+        #pragma omp for
+        for (j = 0; j < no; ++j)
+            u[2*j+1] = o[j];
+    }
+
+    free(fo);
+    free(fe);
+    free(o);
+    free(e);
+    return iters;
+}
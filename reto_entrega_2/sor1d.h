@@ -0,0 +1,26 @@
+#ifndef SOR1D_H_
+#define SOR1D_H_
+
+/* --
+ * Red-black SOR for the 1D Poisson problem of jacobi1d.c, done in place.
+ * The values are split into even points e[j] = u[2j] and odd points
+ * o[j] = u[2j+1]. Updating one colour then reads the other colour at
+ * j and j+1 (or j-1 and j), so both half-sweeps are unit-stride loops
+ * that vectorize and split evenly across OpenMP threads.
+ */
+
+/* omega = 2 / (1 + sin(pi h)), optimal for this matrix (rho_Jacobi = cos(pi h)) */
+double sor_optimal_omega(int n);
+
+/* --
+ * Up to max_iters red-black iterations on u (boundary values in u[0],
+ * u[n]). With tol > 0 the relative residual max|f - Au| / max|f| is
+ * computed every `every` iterations and the solve stops once it is
+ * <= tol, or early when it stops decreasing (round-off floor).
+ * nthreads = 0 keeps the OpenMP default. Returns the iterations done;
+ * *residual gets the last residual measured (-1 if none).
+ */
+int sor_solve(int n, double* u, const double* f, double omega, double tol, int every,
+              int max_iters, int nthreads, double* residual);
+
+#endif /* SOR1D_H_ */
@@ -0,0 +1,194 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../comun/simd.h"
+#include "stencil1d.h"
+
+#define ALIGN 64
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STENCIL_X86 1
+#include <immintrin.h>
+
+#define ATTR_AVX2   __attribute__((target("avx2")))
+#define ATTR_AVX512 __attribute__((target("avx512f")))
+#endif
+
+typedef void (*sweep_d_t)(int n, const double* restrict src, double* restrict dst,
+                          const double* restrict g);
+typedef void (*sweep_f_t)(int n, const float* restrict src, float* restrict dst,
+                          const float* restrict g);
+
+/* Points [i0, i1): the portable kernel, and the peel and tail of the SIMD ones */
+static inline void range_d(int i0, int i1, const double* restrict src, double* restrict dst,
+                           const double* restrict g)
+{
+    int i;
+    for (i = i0; i < i1; ++i)
+        dst[i] = (src[i-1] + src[i+1] + g[i]) * 0.5;
+}
+
+static inline void range_f(int i0, int i1, const float* restrict src, float* restrict dst,
+                           const float* restrict g)
+{
+    int i;
+    for (i = i0; i < i1; ++i)
+        dst[i] = (src[i-1] + src[i+1] + g[i]) * 0.5f;
+}
+
+static void sweep_d_scalar(int n, const double* restrict src, double* restrict dst,
+                           const double* restrict g)
+{
+    range_d(1, n, src, dst, g);
+}
+
+static void sweep_f_scalar(int n, const float* restrict src, float* restrict dst,
+                           const float* restrict g)
+{
+    range_f(1, n, src, dst, g);
+}
+
+#ifdef STENCIL_X86
+/* --
+ * Update points 1..n-1 of dst: scalar up to the first aligned store, W
+ * points per iteration with unaligned loads of the neighbours, then a
+ * scalar tail. The additions are in the same order as the scalar code.
+ */
+#define SWEEP_SIMD(name, T, V, W, RANGE, LOADU, LOAD, STORE, ADD, MUL, SET1, ATTR)  \
+    ATTR static void name(int n, const T* restrict src, T* restrict dst,          \
+                          const T* restrict g)                                    \
+    {                                                                              \
+        int i = 1;                                                                 \
+        const V half = SET1(0.5);                                                  \
+        while (i < n && (uintptr_t) (dst + i) % (W * sizeof(T)) != 0)              \
+            ++i;                                                                   \
+        RANGE(1, i, src, dst, g);                                                  \
+        for (; i + W <= n; i += W) {                                               \
+            V t = ADD(LOADU(src + i - 1), LOADU(src + i + 1));                     \
+            STORE(dst + i, MUL(ADD(t, LOAD(g + i)), half));                        \
+        }                                                                          \
+        RANGE(i, n, src, dst, g);                                                  \
+    }
+
+SWEEP_SIMD(sweep_d_avx2, double, __m256d, 4, range_d, _mm256_loadu_pd, _mm256_load_pd,
+           _mm256_store_pd, _mm256_add_pd, _mm256_mul_pd, _mm256_set1_pd, ATTR_AVX2)
+SWEEP_SIMD(sweep_f_avx2, float, __m256, 8, range_f, _mm256_loadu_ps, _mm256_load_ps,
+           _mm256_store_ps, _mm256_add_ps, _mm256_mul_ps, _mm256_set1_ps, ATTR_AVX2)
+SWEEP_SIMD(sweep_d_avx512, double, __m512d, 8, range_d, _mm512_loadu_pd, _mm512_load_pd,
+           _mm512_store_pd, _mm512_add_pd, _mm512_mul_pd, _mm512_set1_pd, ATTR_AVX512)
+SWEEP_SIMD(sweep_f_avx512, float, __m512, 16, range_f, _mm512_loadu_ps, _mm512_load_ps,
+           _mm512_store_ps, _mm512_add_ps, _mm512_mul_ps, _mm512_set1_ps, ATTR_AVX512)
+#endif
+
+const char* stencil_isa(void)
+{
+    return nombre_simd(detectar_simd());
+}
+
+static sweep_d_t select_d(void)
+{
+#ifdef STENCIL_X86
+    switch (detectar_simd()) {
+    case SIMD_AVX512: return sweep_d_avx512;
+    case SIMD_AVX2:   return sweep_d_avx2;
+    default:          break;
+    }
+#endif
+    return sweep_d_scalar;
+}
+
+static sweep_f_t select_f(void)
+{
+#ifdef STENCIL_X86
+    switch (detectar_simd()) {
+    case SIMD_AVX512: return sweep_f_avx512;
+    case SIMD_AVX2:   return sweep_f_avx2;
+    default:          break;
+    }
+#endif
+    return sweep_f_scalar;
+}
+
+/* 64-byte aligned buffer rounded up to whole cache lines */
+static void* alloc_padded(size_t bytes)
+{
+    void* p = aligned_alloc(ALIGN, (bytes + ALIGN - 1) / ALIGN * ALIGN);
+    if (!p) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+stencil_t* stencil_create(int n, const double* u, const double* f, int single)
+{
+    int i;
+    double h  = 1.0 / n;
+    double h2 = h*h;
+    size_t elem = single ? sizeof(float) : sizeof(double);
+    stencil_t* st = (stencil_t*) malloc(sizeof(stencil_t));
+
+    if (!st) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+    st->n = n;
+    st->single = single;
+    st->a = alloc_padded((n+1) * elem);
+    st->b = alloc_padded((n+1) * elem);
+    st->g = alloc_padded((n+1) * elem);
+    if (single) {
+        float* a = (float*) st->a;
+        float* b = (float*) st->b;
+        float* g = (float*) st->g;
+        for (i = 0; i <= n; ++i) {
+            a[i] = b[i] = (float) u[i];
+            g[i] = (float) (h2*f[i]);
+        }
+    } else {
+        double* a = (double*) st->a;
+        double* b = (double*) st->b;
+        double* g = (double*) st->g;
+        for (i = 0; i <= n; ++i) {
+            a[i] = b[i] = u[i];
+            g[i] = h2*f[i];
+        }
+    }
+    return st;
+}
+
+void stencil_destroy(stencil_t* st)
+{
+    free(st->g);
+    free(st->b);
+    free(st->a);
+    free(st);
+}
+
+void stencil_sweeps(stencil_t* st, int nsweeps)
+{
+    int sweep;
+
+    if (st->single) {
+        sweep_f_t sweep_fn = select_f();
+        for (sweep = 0; sweep < nsweeps; sweep += 2) {
+            sweep_fn(st->n, st->a, st->b, st->g);
+            sweep_fn(st->n, st->b, st->a, st->g);
+        }
+    } else {
+        sweep_d_t sweep_fn = select_d();
+        for (sweep = 0; sweep < nsweeps; sweep += 2) {
+            sweep_fn(st->n, st->a, st->b, st->g);
+            sweep_fn(st->n, st->b, st->a, st->g);
+        }
+    }
+}
+
+void stencil_get(const stencil_t* st, double* u)
+{
+    int i;
+
+    for (i = 1; i < st->n; ++i)
+        u[i] = st->single ? ((const float*) st->a)[i] : ((const double*) st->a)[i];
+}
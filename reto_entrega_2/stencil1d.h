@@ -0,0 +1,36 @@
+#ifndef STENCIL1D_H_
+#define STENCIL1D_H_
+
+/* --
+ * Jacobi sweeps of jacobi1d.c with explicit AVX2/AVX-512 kernels chosen
+ * at run time (detectar_simd() in comun/simd.c; HPC_SIMD=escalar|avx2
+ * forces a lower level). The right-hand side is scaled once,
+ * g[i] = h2*f[i], and the division by 2 becomes a multiplication by 0.5,
+ * which is exact. The double kernels therefore give the same bits as
+ * jacobi(), provided jacobi() is not compiled with h2*f[i] + ... fused
+ * into an FMA (jacobi1d.c turns contraction off for that reason).
+ * The work arrays are 64-byte aligned and padded to whole cache lines,
+ * and each sweep peels points until the stores are aligned.
+ */
+typedef struct {
+    int n;
+    int single;         /* 1: float arrays, half the bytes per point */
+    void* a;            /* Current values, u[0..n] */
+    void* b;            /* Values of the other half of a sweep pair */
+    void* g;            /* h2*f */
+} stencil_t;
+
+/* Name of the selected kernel: "avx512", "avx2" or "escalar" */
+const char* stencil_isa(void);
+
+/* Copy u and scale f into aligned arrays; set up outside the timed sweeps */
+stencil_t* stencil_create(int n, const double* u, const double* f, int single);
+void stencil_destroy(stencil_t* st);
+
+/* Same sweeps as jacobi() (nsweeps rounded up to a pair) */
+void stencil_sweeps(stencil_t* st, int nsweeps);
+
+/* Copy the interior values back into u */
+void stencil_get(const stencil_t* st, double* u);
+
+#endif /* STENCIL1D_H_ */
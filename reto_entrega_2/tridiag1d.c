@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tridiag1d.h"
+
+void tridiag_solve(int m, double* x, const double* f, double h2, double left, double right)
+{
+    int k;
+    double r;
+
+    if (m == 0)
+        return;
+    /* Forward elimination. The pivot of row k is (k+2)/(k+1), so the
+     * modified super-diagonal is -(k+1)/(k+2) and needs no storage */
+    x[0] = (h2*f[0] + left) / 2;
+    for (k = 1; k < m; ++k) {
+        r = (double) (k + 1) / (k + 2);         /* Off the dependency chain */
+        x[k] = (h2*f[k] + x[k-1]) * r;
+    }
+    x[m-1] += right * m / (m + 1);
+
+    /* Back substitution */
+    for (k = m - 2; k >= 0; --k) {
+        r = (double) (k + 1) / (k + 2);
+        x[k] += r * x[k+1];
+    }
+}
+
+void tridiag_correct(int m, double* x, double left, double right)
+{
+    int t;
+    double s = 1.0 / (m + 1);
+
+    for (t = 0; t < m; ++t)
+        x[t] += ((m - t) * left + (t + 1) * right) * s;
+}
+
+void tridiag_separators(int nblocks, const tridiag_block_t* b, double* xsep)
+{
+    int k, ns = nblocks - 1;
+    double* c = (double*) malloc((ns > 0 ? ns : 1) * sizeof(double));
+    double* x = xsep + 1;
+    double lo, up, diag, piv, ml, mr;
+
+    if (!c) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Row k (separator after block k): the last point of block k and the
+     * first of block k+1 are their zero-boundary values plus the
+     * interpolation weights times the neighbouring separators */
+    for (k = 0; k < ns; ++k) {
+        ml = b[k].m;
+        mr = b[k+1].m;
+        lo   = -1 / (ml + 1);                       /* Coefficient of xsep[k] */
+        diag = 2 - ml / (ml + 1) - mr / (mr + 1);
+        up   = -1 / (mr + 1);                       /* Coefficient of xsep[k+2] */
+        x[k] = b[k].rhs + b[k].last + b[k+1].first;
+        if (k == 0)
+            x[k] -= lo * xsep[0];
+        if (k == ns - 1)
+            x[k] -= up * xsep[nblocks];
+
+        /* Thomas forward elimination, one row at a time */
+        piv = (k == 0) ? diag : diag - lo * c[k-1];
+        c[k] = up / piv;
+        x[k] = (k == 0) ? x[k] / piv : (x[k] - lo * x[k-1]) / piv;
+    }
+    for (k = ns - 2; k >= 0; --k)
+        x[k] -= c[k] * x[k+1];
+    free(c);
+}
+
+void tridiag_poisson(int n, double* u, const double* f)
+{
+    double h = 1.0 / n;
+
+    tridiag_solve(n - 1, u + 1, f + 1, h*h, u[0], u[n]);
+}
+
+int tridiag_poisson_threads(int n, double* u, const double* f, int nthreads)
+{
+    double h  = 1.0 / n;
+    double h2 = h*h;
+    int* sep;
+    double* xsep;
+    tridiag_block_t* b;
+
+    /* Every block needs its separator: at most n-1 blocks */
+    if (nthreads > n - 1)
+        nthreads = n - 1;
+    if (nthreads < 1)
+        nthreads = 1;
+    sep  = (int*) malloc((nthreads + 1) * sizeof(int));
+    xsep = (double*) malloc((nthreads + 1) * sizeof(double));
+    b    = (tridiag_block_t*) malloc(nthreads * sizeof(tridiag_block_t));
+    if (!sep || !xsep || !b) {
+        perror("Error al asignar memoria");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Block k is the open interval (sep[k], sep[k+1]); the interior
+     * points 1..n-1 are split evenly and the last point of each share but
+     * the last one becomes a separator */
+    sep[0] = 0;
+    sep[nthreads] = n;
+    xsep[0] = u[0];
+    xsep[nthreads] = u[n];
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int k;
+
+        #pragma omp for
+        for (k = 1; k < nthreads; ++k)
+            sep[k] = (int) ((long) (n - 1) * k / nthreads);
+
+        /* Zero-boundary solve of each block */
+        #pragma omp for
+        for (k = 0; k < nthreads; ++k) {
+            double* x = u + sep[k] + 1;
+            b[k].m = sep[k+1] - sep[k] - 1;
+            tridiag_solve(b[k].m, x, f + sep[k] + 1, h2, 0, 0);
+            b[k].first = b[k].m > 0 ? x[0] : 0;
+            b[k].last  = b[k].m > 0 ? x[b[k].m - 1] : 0;
+            b[k].rhs   = (k < nthreads - 1) ? h2*f[sep[k+1]] : 0;
+        }
+
+        #pragma omp single
+        {
+            tridiag_separators(nthreads, b, xsep);
+            for (k = 1; k < nthreads; ++k)
+                u[sep[k]] = xsep[k];
+        }
+
+        #pragma omp for
+        for (k = 0; k < nthreads; ++k)
+            tridiag_correct(b[k].m, u + sep[k] + 1, xsep[k], xsep[k+1]);
+    }
+
+    free(b);
+    free(xsep);
+    free(sep);
+    return nthreads;
+}
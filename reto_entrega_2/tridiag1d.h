@@ -0,0 +1,53 @@
+#ifndef TRIDIAG1D_H_
+#define TRIDIAG1D_H_
+
+/* --
+ * Direct solvers for the system behind jacobi1d.c,
+ *
+ *    -u[i-1] + 2 u[i] - u[i+1] = h^2 f[i],   i = 1, ..., n-1,
+ *
+ * with u[0] and u[n] given. The Thomas algorithm solves it in O(n).
+ *
+ * The partitioned solver (SPIKE with separators) cuts the interior into
+ * blocks separated by single points. Each block is solved independently
+ * with zero boundary values. For this matrix the response of a block of
+ * m points to its boundary values is linear interpolation, so the true
+ * solution is the zero-boundary one plus
+ *
+ *    x[t] += (m - t)/(m + 1) * left + (t + 1)/(m + 1) * right.
+ *
+ * Substituting that into the equations at the separators leaves a
+ * tridiagonal system with one unknown per separator. It is tiny (one row
+ * per thread or rank) and is solved serially.
+ */
+
+/* Per-block data for the separator system */
+typedef struct {
+    int m;              /* Points in the block */
+    double first;       /* Zero-boundary solution at the first and last point */
+    double last;
+    double rhs;         /* h^2 f at the separator after the block */
+} tridiag_block_t;
+
+/* Thomas solve of the m-point block x[0..m-1] with right-hand side
+ * h2*f[0..m-1] and boundary values left (before x[0]) and right (after x[m-1]) */
+void tridiag_solve(int m, double* x, const double* f, double h2, double left, double right);
+
+/* Add the response to boundary values left, right to a zero-boundary block solution */
+void tridiag_correct(int m, double* x, double left, double right);
+
+/* --
+ * Solve the separator system for nblocks blocks. xsep[0] and
+ * xsep[nblocks] hold the boundary values; xsep[1..nblocks-1] receive
+ * the values at the separators after blocks 0..nblocks-2.
+ */
+void tridiag_separators(int nblocks, const tridiag_block_t* b, double* xsep);
+
+/* Direct solve on u (boundary values in u[0], u[n]): serial Thomas */
+void tridiag_poisson(int n, double* u, const double* f);
+
+/* Same system with the partitioned solver over nthreads OpenMP threads;
+ * returns the number of blocks used */
+int tridiag_poisson_threads(int n, double* u, const double* f, int nthreads);
+
+#endif /* TRIDIAG1D_H_ */